@@ -0,0 +1,239 @@
+#pragma once
+
+#include "Types/Types.h"
+#include "Utility/Swap.h"
+
+#ifdef _WIN32
+
+/*
+	The Win32 functions MappedFile calls, declared as <windows.h> declares
+	them so that the header does not pull in <windows.h> and its macros.
+	Handles are void*, DWORD is unsigned long and BOOL is int.
+*/
+struct _SECURITY_ATTRIBUTES;
+union _LARGE_INTEGER;
+
+extern "C"
+{
+	__declspec(dllimport) void* __stdcall CreateFileA(const char* lpFileName, unsigned long dwDesiredAccess,
+		unsigned long dwShareMode, _SECURITY_ATTRIBUTES* lpSecurityAttributes, unsigned long dwCreationDisposition,
+		unsigned long dwFlagsAndAttributes, void* hTemplateFile);
+
+	__declspec(dllimport) int __stdcall GetFileSizeEx(void* hFile, _LARGE_INTEGER* lpFileSize);
+
+	__declspec(dllimport) void* __stdcall CreateFileMappingA(void* hFile, _SECURITY_ATTRIBUTES* lpFileMappingAttributes,
+		unsigned long flProtect, unsigned long dwMaximumSizeHigh, unsigned long dwMaximumSizeLow, const char* lpName);
+
+#ifdef _WIN64
+	__declspec(dllimport) void* __stdcall MapViewOfFile(void* hFileMappingObject, unsigned long dwDesiredAccess,
+		unsigned long dwFileOffsetHigh, unsigned long dwFileOffsetLow, unsigned __int64 dwNumberOfBytesToMap);
+#else
+	__declspec(dllimport) void* __stdcall MapViewOfFile(void* hFileMappingObject, unsigned long dwDesiredAccess,
+		unsigned long dwFileOffsetHigh, unsigned long dwFileOffsetLow, unsigned long dwNumberOfBytesToMap);
+#endif
+
+	__declspec(dllimport) int __stdcall UnmapViewOfFile(const void* lpBaseAddress);
+
+	__declspec(dllimport) int __stdcall CloseHandle(void* hObject);
+}
+
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace Quartz
+{
+	/*====================================================
+	|	             QUARTZLIB MAPPED FILE               |
+	=====================================================*/
+
+	/* A read-only memory-mapped file */
+	class MappedFile
+	{
+	private:
+#ifdef _WIN32
+		// The <windows.h> values used, see the declarations above
+		constexpr static unsigned long WIN_GENERIC_READ				= 0x80000000ul;
+		constexpr static unsigned long WIN_FILE_SHARE_READ			= 0x1ul;
+		constexpr static unsigned long WIN_OPEN_EXISTING			= 3ul;
+		constexpr static unsigned long WIN_FILE_ATTRIBUTE_NORMAL	= 0x80ul;
+		constexpr static unsigned long WIN_PAGE_READONLY			= 0x2ul;
+		constexpr static unsigned long WIN_FILE_MAP_READ			= 0x4ul;
+
+		static void* InvalidHandle()
+		{
+			return reinterpret_cast<void*>(static_cast<sSize>(-1));
+		}
+#endif
+
+		const void*	mpData;
+		uSize		mSize;
+
+#ifdef _WIN32
+		void*		mFile;
+		void*		mMapping;
+#endif
+
+	private:
+		friend void Swap(MappedFile& file1, MappedFile& file2)
+		{
+			using Quartz::Swap;
+			Swap(file1.mpData, file2.mpData);
+			Swap(file1.mSize, file2.mSize);
+#ifdef _WIN32
+			Swap(file1.mFile, file2.mFile);
+			Swap(file1.mMapping, file2.mMapping);
+#endif
+		}
+
+	public:
+		MappedFile()
+			: mpData(nullptr), mSize(0)
+#ifdef _WIN32
+			, mFile(InvalidHandle()), mMapping(nullptr)
+#endif
+		{ }
+
+		MappedFile(const char* pPath)
+			: MappedFile()
+		{
+			Open(pPath);
+		}
+
+		MappedFile(const MappedFile&) = delete;
+
+		MappedFile(MappedFile&& file) noexcept
+			: MappedFile()
+		{
+			Swap(*this, file);
+		}
+
+		~MappedFile()
+		{
+			Close();
+		}
+
+		bool Open(const char* pPath)
+		{
+			Close();
+
+#ifdef _WIN32
+			mFile = ::CreateFileA(pPath, WIN_GENERIC_READ, WIN_FILE_SHARE_READ, nullptr,
+				WIN_OPEN_EXISTING, WIN_FILE_ATTRIBUTE_NORMAL, nullptr);
+
+			if (mFile == InvalidHandle())
+			{
+				return false;
+			}
+
+			// A LARGE_INTEGER is a union over one 64-bit integer
+			int64 fileSize = 0;
+
+			if (!::GetFileSizeEx(mFile, reinterpret_cast<_LARGE_INTEGER*>(&fileSize)) || fileSize == 0)
+			{
+				Close();
+				return false;
+			}
+
+			mMapping = ::CreateFileMappingA(mFile, nullptr, WIN_PAGE_READONLY, 0, 0, nullptr);
+
+			if (!mMapping)
+			{
+				Close();
+				return false;
+			}
+
+			mpData = ::MapViewOfFile(mMapping, WIN_FILE_MAP_READ, 0, 0, 0);
+			mSize = static_cast<uSize>(fileSize);
+#else
+			int file = open(pPath, O_RDONLY);
+
+			if (file < 0)
+			{
+				return false;
+			}
+
+			struct stat fileStat;
+
+			if (fstat(file, &fileStat) != 0 || fileStat.st_size == 0)
+			{
+				close(file);
+				return false;
+			}
+
+			void* pMapped = mmap(nullptr, fileStat.st_size, PROT_READ, MAP_SHARED, file, 0);
+			close(file);
+
+			if (pMapped == MAP_FAILED)
+			{
+				return false;
+			}
+
+			mpData = pMapped;
+			mSize = static_cast<uSize>(fileStat.st_size);
+#endif
+
+			if (!mpData)
+			{
+				Close();
+				return false;
+			}
+
+			return true;
+		}
+
+		void Close()
+		{
+#ifdef _WIN32
+			if (mpData)
+			{
+				::UnmapViewOfFile(mpData);
+			}
+
+			if (mMapping)
+			{
+				::CloseHandle(mMapping);
+			}
+
+			if (mFile != InvalidHandle())
+			{
+				::CloseHandle(mFile);
+			}
+
+			mMapping = nullptr;
+			mFile = InvalidHandle();
+#else
+			if (mpData)
+			{
+				munmap(const_cast<void*>(mpData), mSize);
+			}
+#endif
+			mpData = nullptr;
+			mSize = 0;
+		}
+
+		MappedFile& operator=(MappedFile file)
+		{
+			Swap(*this, file);
+			return *this;
+		}
+
+		const void* Data() const
+		{
+			return mpData;
+		}
+
+		uSize Size() const
+		{
+			return mSize;
+		}
+
+		bool IsOpen() const
+		{
+			return mpData != nullptr;
+		}
+	};
+}
\ No newline at end of file
@@ -2,8 +2,13 @@
 
 #include "Types/Types.h"
 #include <memory>
+#include <cstdlib>
 #include <cstring>
 
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <xmmintrin.h>
+#endif
+
 namespace Quartz
 {
 	/*====================================================
@@ -34,10 +39,26 @@ namespace Quartz
 		return memmove(pDest, pSource, size);
 	}
 
+	// Hints the cpu to load the cache line containing pMemory
+	inline void MemPrefetch(const void* pMemory)
+	{
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+		_mm_prefetch(reinterpret_cast<const char*>(pMemory), _MM_HINT_T0);
+#elif defined(__GNUC__) || defined(__clang__)
+		__builtin_prefetch(pMemory);
+#else
+		(void)pMemory;
+#endif
+	}
+
 	// TODO: Implement later (with intrinsics)
 	inline void* MemCopy(void* pDest, const void* pSource, uSize size)
 	{
+#if defined(_MSC_VER)
 		memcpy_s(pDest, size, pSource, size);
+#else
+		memcpy(pDest, pSource, size);
+#endif
 		return pDest;
 	}
 }
\ No newline at end of file
@@ -5,22 +5,40 @@
 =====================================================*/
 
 #include "Types/Array.h"
-#include "Types/BlockSet.h"
+#include "Types/BloomFilter.h"
+#include "Types/BTree.h"
+#include "Types/Cache.h"
+#include "Types/ConcurrentMap.h"
+#include "Types/CountMap.h"
+#include "Types/CuckooFilter.h"
+#include "Types/FrozenMap.h"
 #include "Types/List.h"
 #include "Types/Map.h"
+#include "Types/MultiMap.h"
+#include "Types/Name.h"
 #include "Types/Set.h"
-#include "Types/SparseSet.h"
+#include "Types/Special/BlockSet.h"
+#include "Types/Special/SparseSet.h"
 #include "Types/Stack.h"
 #include "Types/String.h"
+#include "Types/StringBuilder.h"
 #include "Types/Table.h"
+#include "Types/TableSnapshot.h"
 #include "Types/Tuple.h"
 #include "Types/Types.h"
 #include "Utility/Fold.h"
 #include "Utility/Hash.h"
+#include "Utility/HashQuality.h"
 #include "Utility/InitializerList.h"
 #include "Utility/Iterator.h"
 #include "Utility/Move.h"
+#include "Utility/NumberFormat.h"
+#include "Utility/SetAlgebra.h"
+#include "Utility/SpinLock.h"
+#include "Utility/StreamReader.h"
+#include "Utility/StringSearch.h"
 #include "Utility/Swap.h"
 #include "Utility/Template.h"
 #include "Utility/TypeId.h"
-#include "Memory/Memory.h"
\ No newline at end of file
+#include "Memory/Memory.h"
+#include "Memory/MappedFile.h"
\ No newline at end of file
@@ -100,7 +100,7 @@ namespace Quartz
 		{
 			if constexpr (IS_SMALL)
 			{
-				mpData = mSmall;
+				mpData = this->mSmall;
 				mCapacity = SMALL_SIZE;
 			}
 		}
@@ -115,7 +115,7 @@ namespace Quartz
 					assert(false && "Cannot construct a 'small' Array (SMALL_SIZE > 0) with a size greater than SMALL_SIZE.");
 				}
 
-				mpData = mSmall;
+				mpData = this->mSmall;
 				mCapacity = SMALL_SIZE;
 			}
 			else
@@ -142,7 +142,7 @@ namespace Quartz
 				assert(array.Size() >= SMALL_SIZE && "A 'small' Array (SMALL_SIZE > 0) can only be coppied to a 'large'\
  Array (SMALL_SIZE == 0) , or a 'small' Array of a greater or equal size.");
 
-				mpData = mSmall;
+				mpData = this->mSmall;
 				mCapacity = SMALL_SIZE;
 			}
 			else
@@ -164,7 +164,7 @@ namespace Quartz
 				assert(array.Size() <= SMALL_SIZE && "A 'small' Array (SMALL_SIZE > 0) can only be coppied to a 'large'\
  Array (SMALL_SIZE == 0), or a 'small' Array of a greater or equal size.");
 		
-				mpData = mSmall;
+				mpData = this->mSmall;
 				mCapacity = SMALL_SIZE;
 			}
 			else
@@ -213,8 +213,12 @@ namespace Quartz
 			}
 			else
 			{
-				// Move all values right by one
+				// Move all values right by one, over the spare value at the end
+				mpData[mSize].~ValueType();
 				MemMove(&mpData[1], &mpData[0], mSize * sizeof(ValueType));
+
+				// The first slot is now a bitwise copy of the second, replace it without destroying it
+				new (&mpData[0]) ValueType();
 			}
 
 			++mSize;
@@ -248,7 +252,7 @@ namespace Quartz
 				mpData[index].~ValueType();
 
 				// Move all values left by one
-				MemMove(&mpData[index], &mpData[index + 1], (mSize - index) * sizeof(ValueType));
+				MemMove(&mpData[index], &mpData[index + 1], (mSize - index - 1) * sizeof(ValueType));
 				--mSize;
 
 				new (&mpData[mSize]) ValueType();
@@ -0,0 +1,1191 @@
+#pragma once
+
+#include "Types.h"
+#include "Array.h"
+#include "Map.h"
+#include "Utility/Swap.h"
+#include "Utility/Move.h"
+
+#include <assert.h>
+#include <type_traits>
+
+namespace Quartz
+{
+	/*====================================================
+	|                  QUARTZLIB B-TREE                  |
+	=====================================================*/
+
+	struct _BTreeMapKeyOf
+	{
+		template<typename KeyType, typename ValueType>
+		static const KeyType& Get(const MapPair<KeyType, ValueType>& pair)
+		{
+			return pair.key;
+		}
+	};
+
+	struct _BTreeSetKeyOf
+	{
+		template<typename KeyType>
+		static const KeyType& Get(const KeyType& key)
+		{
+			return key;
+		}
+	};
+
+	/* A [first, last) range of B-tree entries */
+	template<typename IteratorType>
+	class BTreeRange
+	{
+	private:
+		IteratorType mFirst;
+		IteratorType mLast;
+
+	public:
+		BTreeRange(const IteratorType& first, const IteratorType& last)
+			: mFirst(first), mLast(last) {}
+
+		IteratorType Begin() const
+		{
+			return mFirst;
+		}
+
+		IteratorType End() const
+		{
+			return mLast;
+		}
+
+		bool IsEmpty() const
+		{
+			return mFirst == mLast;
+		}
+
+		// for-each functions:
+
+		IteratorType begin() const
+		{
+			return mFirst;
+		}
+
+		IteratorType end() const
+		{
+			return mLast;
+		}
+	};
+
+	/*
+		An ordered B+ tree. Entries are kept sorted in linked leaves, and
+		inner nodes hold only separator keys, so a lookup touches one node
+		per level and ordered scans walk leaves sequentially.
+
+		Nodes are sized to about NODE_BYTES (a few cache lines). Within a
+		node, arithmetic keys are searched with a branchless linear scan the
+		compiler vectorizes, other keys with a binary search.
+
+		Keys only require operator<.
+	*/
+	template<typename KeyType, typename EntryType, typename KeyOfType>
+	class _BTree
+	{
+	public:
+		constexpr static uSize NODE_BYTES		= 256;
+		constexpr static uSize LEAF_CAPACITY	= NODE_BYTES / sizeof(EntryType) > 4 ? NODE_BYTES / sizeof(EntryType) : 4;
+		constexpr static uSize INNER_CAPACITY	= NODE_BYTES / sizeof(KeyType) > 4 ? NODE_BYTES / sizeof(KeyType) : 4;
+		constexpr static uSize LEAF_MIN			= LEAF_CAPACITY / 2;
+		constexpr static uSize INNER_MIN		= INNER_CAPACITY / 2;
+
+	protected:
+		struct Node
+		{
+			bool	isLeaf;
+			uSize	count;
+
+			Node(bool isLeaf)
+				: isLeaf(isLeaf), count(0) {}
+		};
+
+		// Nodes hold one spare slot so an insert can overflow before splitting
+
+		struct Leaf : public Node
+		{
+			Leaf*		pPrev;
+			Leaf*		pNext;
+			EntryType	entries[LEAF_CAPACITY + 1];
+
+			Leaf()
+				: Node(true), pPrev(nullptr), pNext(nullptr), entries() {}
+		};
+
+		struct Inner : public Node
+		{
+			KeyType		keys[INNER_CAPACITY + 1];
+			Node*		pChildren[INNER_CAPACITY + 2];
+
+			Inner()
+				: Node(false), keys(), pChildren() {}
+		};
+
+	public:
+		template<typename LeafType, typename IterEntryType>
+		class IteratorBase
+		{
+		public:
+			LeafType*	pLeaf;
+			uSize		index;
+
+		public:
+			IteratorBase()
+				: pLeaf(nullptr), index(0) {}
+
+			IteratorBase(LeafType* pLeaf, uSize index)
+				: pLeaf(pLeaf), index(index) {}
+
+			template<typename OtherLeafType, typename OtherEntryType>
+			IteratorBase(const IteratorBase<OtherLeafType, OtherEntryType>& it)
+				: pLeaf(it.pLeaf), index(it.index) {}
+
+			IterEntryType& operator*() const
+			{
+				return pLeaf->entries[index];
+			}
+
+			IterEntryType* operator->() const
+			{
+				return &pLeaf->entries[index];
+			}
+
+			IteratorBase& operator++()
+			{
+				if (++index >= pLeaf->count)
+				{
+					pLeaf = pLeaf->pNext;
+					index = 0;
+				}
+
+				return *this;
+			}
+
+			IteratorBase operator++(int)
+			{
+				IteratorBase temp(*this);
+				++(*this);
+				return temp;
+			}
+
+			/* Note: Decrementing End() is not supported, see Last() */
+			IteratorBase& operator--()
+			{
+				if (index == 0)
+				{
+					pLeaf = pLeaf->pPrev;
+					index = pLeaf ? pLeaf->count - 1 : 0;
+				}
+				else
+				{
+					--index;
+				}
+
+				return *this;
+			}
+
+			IteratorBase operator--(int)
+			{
+				IteratorBase temp(*this);
+				--(*this);
+				return temp;
+			}
+
+			template<typename OtherLeafType, typename OtherEntryType>
+			bool operator==(const IteratorBase<OtherLeafType, OtherEntryType>& it) const
+			{
+				return pLeaf == it.pLeaf && index == it.index;
+			}
+
+			template<typename OtherLeafType, typename OtherEntryType>
+			bool operator!=(const IteratorBase<OtherLeafType, OtherEntryType>& it) const
+			{
+				return !(*this == it);
+			}
+		};
+
+		using Iterator		= IteratorBase<Leaf, EntryType>;
+		using ConstIterator	= IteratorBase<const Leaf, const EntryType>;
+
+	protected:
+		Node*	mpRoot;
+		uSize	mSize;
+
+	protected:
+		friend void Swap(_BTree& tree1, _BTree& tree2)
+		{
+			using Quartz::Swap;
+			Swap(tree1.mpRoot, tree2.mpRoot);
+			Swap(tree1.mSize, tree2.mSize);
+		}
+
+		static const KeyType& KeyOf(const EntryType& entry)
+		{
+			return KeyOfType::Get(entry);
+		}
+
+		/* Index of the child of pInner whose subtree may contain key */
+		static uSize ChildIndex(const Inner* pInner, const KeyType& key)
+		{
+			if constexpr (std::is_arithmetic<KeyType>::value)
+			{
+				uSize index = 0;
+
+				for (uSize i = 0; i < pInner->count; i++)
+				{
+					index += !(key < pInner->keys[i]);
+				}
+
+				return index;
+			}
+			else
+			{
+				uSize low	= 0;
+				uSize high	= pInner->count;
+
+				while (low < high)
+				{
+					const uSize mid = (low + high) / 2;
+
+					if (key < pInner->keys[mid])
+					{
+						high = mid;
+					}
+					else
+					{
+						low = mid + 1;
+					}
+				}
+
+				return low;
+			}
+		}
+
+		/* Index of the first entry of pLeaf not less than key */
+		static uSize LeafLowerBound(const Leaf* pLeaf, const KeyType& key)
+		{
+			if constexpr (std::is_arithmetic<KeyType>::value)
+			{
+				uSize index = 0;
+
+				for (uSize i = 0; i < pLeaf->count; i++)
+				{
+					index += KeyOf(pLeaf->entries[i]) < key;
+				}
+
+				return index;
+			}
+			else
+			{
+				uSize low	= 0;
+				uSize high	= pLeaf->count;
+
+				while (low < high)
+				{
+					const uSize mid = (low + high) / 2;
+
+					if (KeyOf(pLeaf->entries[mid]) < key)
+					{
+						low = mid + 1;
+					}
+					else
+					{
+						high = mid;
+					}
+				}
+
+				return low;
+			}
+		}
+
+		/* Index of the first entry of pLeaf greater than key */
+		static uSize LeafUpperBound(const Leaf* pLeaf, const KeyType& key)
+		{
+			if constexpr (std::is_arithmetic<KeyType>::value)
+			{
+				uSize index = 0;
+
+				for (uSize i = 0; i < pLeaf->count; i++)
+				{
+					index += !(key < KeyOf(pLeaf->entries[i]));
+				}
+
+				return index;
+			}
+			else
+			{
+				uSize low	= 0;
+				uSize high	= pLeaf->count;
+
+				while (low < high)
+				{
+					const uSize mid = (low + high) / 2;
+
+					if (key < KeyOf(pLeaf->entries[mid]))
+					{
+						high = mid;
+					}
+					else
+					{
+						low = mid + 1;
+					}
+				}
+
+				return low;
+			}
+		}
+
+		Leaf* FindLeaf(const KeyType& key) const
+		{
+			Node* pNode = mpRoot;
+
+			while (pNode && !pNode->isLeaf)
+			{
+				const Inner* pInner = static_cast<const Inner*>(pNode);
+				pNode = pInner->pChildren[ChildIndex(pInner, key)];
+			}
+
+			return static_cast<Leaf*>(pNode);
+		}
+
+		Iterator FindImpl(const KeyType& key) const
+		{
+			Leaf* pLeaf = FindLeaf(key);
+
+			if (pLeaf)
+			{
+				const uSize index = LeafLowerBound(pLeaf, key);
+
+				if (index < pLeaf->count && !(key < KeyOf(pLeaf->entries[index])))
+				{
+					return Iterator(pLeaf, index);
+				}
+			}
+
+			return Iterator();
+		}
+
+		/* Moves an iterator one past the end of its leaf onto the next leaf */
+		static Iterator Normalize(Leaf* pLeaf, uSize index)
+		{
+			if (!pLeaf)
+			{
+				return Iterator();
+			}
+
+			if (index >= pLeaf->count)
+			{
+				return Iterator(pLeaf->pNext, 0);
+			}
+
+			return Iterator(pLeaf, index);
+		}
+
+		/*
+			Inserts entry into the subtree of pNode. If pNode splits, returns the
+			new right sibling and writes the separator of the two to outSeparator.
+		*/
+		Node* InsertNode(Node* pNode, EntryType& entry, bool replace, EntryType*& pOutEntry,
+			bool& outInserted, KeyType& outSeparator)
+		{
+			if (pNode->isLeaf)
+			{
+				Leaf* pLeaf = static_cast<Leaf*>(pNode);
+				const uSize index = LeafLowerBound(pLeaf, KeyOf(entry));
+
+				if (index < pLeaf->count && !(KeyOf(entry) < KeyOf(pLeaf->entries[index])))
+				{
+					if (replace)
+					{
+						pLeaf->entries[index] = Move(entry);
+					}
+
+					pOutEntry	= &pLeaf->entries[index];
+					outInserted	= false;
+
+					return nullptr;
+				}
+
+				for (uSize i = pLeaf->count; i > index; i--)
+				{
+					pLeaf->entries[i] = Move(pLeaf->entries[i - 1]);
+				}
+
+				pLeaf->entries[index] = Move(entry);
+				pLeaf->count++;
+
+				outInserted = true;
+
+				if (pLeaf->count <= LEAF_CAPACITY)
+				{
+					pOutEntry = &pLeaf->entries[index];
+					return nullptr;
+				}
+
+				// Split the overflowing leaf in half
+
+				Leaf* pRight = new Leaf();
+				const uSize mid = pLeaf->count / 2;
+
+				for (uSize i = mid; i < pLeaf->count; i++)
+				{
+					pRight->entries[i - mid] = Move(pLeaf->entries[i]);
+				}
+
+				pRight->count	= pLeaf->count - mid;
+				pLeaf->count	= mid;
+
+				pRight->pPrev = pLeaf;
+				pRight->pNext = pLeaf->pNext;
+
+				if (pLeaf->pNext)
+				{
+					pLeaf->pNext->pPrev = pRight;
+				}
+
+				pLeaf->pNext = pRight;
+
+				pOutEntry		= index < mid ? &pLeaf->entries[index] : &pRight->entries[index - mid];
+				outSeparator	= KeyOf(pRight->entries[0]);
+
+				return pRight;
+			}
+
+			Inner* pInner = static_cast<Inner*>(pNode);
+			const uSize childIndex = ChildIndex(pInner, KeyOf(entry));
+
+			KeyType childSeparator;
+			Node* pChildSplit = InsertNode(pInner->pChildren[childIndex], entry, replace,
+				pOutEntry, outInserted, childSeparator);
+
+			if (!pChildSplit)
+			{
+				return nullptr;
+			}
+
+			for (uSize i = pInner->count; i > childIndex; i--)
+			{
+				pInner->keys[i]			= Move(pInner->keys[i - 1]);
+				pInner->pChildren[i + 1]	= pInner->pChildren[i];
+			}
+
+			pInner->keys[childIndex]			= Move(childSeparator);
+			pInner->pChildren[childIndex + 1]	= pChildSplit;
+			pInner->count++;
+
+			if (pInner->count <= INNER_CAPACITY)
+			{
+				return nullptr;
+			}
+
+			// Split the overflowing inner node, the middle key moves up
+
+			Inner* pRight = new Inner();
+			const uSize mid = pInner->count / 2;
+			const uSize rightCount = pInner->count - mid - 1;
+
+			for (uSize i = 0; i < rightCount; i++)
+			{
+				pRight->keys[i] = Move(pInner->keys[mid + 1 + i]);
+			}
+
+			for (uSize i = 0; i <= rightCount; i++)
+			{
+				pRight->pChildren[i] = pInner->pChildren[mid + 1 + i];
+			}
+
+			outSeparator	= Move(pInner->keys[mid]);
+			pRight->count	= rightCount;
+			pInner->count	= mid;
+
+			return pRight;
+		}
+
+		EntryType& InsertImpl(EntryType& entry, bool replace, bool& outInserted)
+		{
+			if (!mpRoot)
+			{
+				mpRoot = new Leaf();
+			}
+
+			EntryType* pEntry = nullptr;
+			KeyType separator;
+
+			Node* pSplit = InsertNode(mpRoot, entry, replace, pEntry, outInserted, separator);
+
+			if (pSplit)
+			{
+				Inner* pRoot = new Inner();
+				pRoot->keys[0]		= Move(separator);
+				pRoot->pChildren[0]	= mpRoot;
+				pRoot->pChildren[1]	= pSplit;
+				pRoot->count		= 1;
+
+				mpRoot = pRoot;
+			}
+
+			if (outInserted)
+			{
+				mSize++;
+			}
+
+			return *pEntry;
+		}
+
+		/* Removes the separator at index and the child to its right */
+		static void RemoveSeparator(Inner* pInner, uSize index)
+		{
+			for (uSize i = index; i + 1 < pInner->count; i++)
+			{
+				pInner->keys[i]			= Move(pInner->keys[i + 1]);
+				pInner->pChildren[i + 1]	= pInner->pChildren[i + 2];
+			}
+
+			pInner->count--;
+			pInner->keys[pInner->count] = KeyType();
+		}
+
+		/* Merges child index + 1 of pParent into child index */
+		static void MergeChildren(Inner* pParent, uSize index)
+		{
+			Node* pLeftNode		= pParent->pChildren[index];
+			Node* pRightNode	= pParent->pChildren[index + 1];
+
+			if (pLeftNode->isLeaf)
+			{
+				Leaf* pLeft		= static_cast<Leaf*>(pLeftNode);
+				Leaf* pRight	= static_cast<Leaf*>(pRightNode);
+
+				for (uSize i = 0; i < pRight->count; i++)
+				{
+					pLeft->entries[pLeft->count + i] = Move(pRight->entries[i]);
+				}
+
+				pLeft->count += pRight->count;
+				pLeft->pNext = pRight->pNext;
+
+				if (pRight->pNext)
+				{
+					pRight->pNext->pPrev = pLeft;
+				}
+
+				delete pRight;
+			}
+			else
+			{
+				Inner* pLeft	= static_cast<Inner*>(pLeftNode);
+				Inner* pRight	= static_cast<Inner*>(pRightNode);
+
+				pLeft->keys[pLeft->count] = Move(pParent->keys[index]);
+
+				for (uSize i = 0; i < pRight->count; i++)
+				{
+					pLeft->keys[pLeft->count + 1 + i] = Move(pRight->keys[i]);
+				}
+
+				for (uSize i = 0; i <= pRight->count; i++)
+				{
+					pLeft->pChildren[pLeft->count + 1 + i] = pRight->pChildren[i];
+				}
+
+				pLeft->count += pRight->count + 1;
+
+				delete pRight;
+			}
+
+			RemoveSeparator(pParent, index);
+		}
+
+		/* Restores the minimum fill of child index of pParent */
+		static void Rebalance(Inner* pParent, uSize index)
+		{
+			Node* pChild		= pParent->pChildren[index];
+			Node* pLeftNode		= index > 0 ? pParent->pChildren[index - 1] : nullptr;
+			Node* pRightNode	= index < pParent->count ? pParent->pChildren[index + 1] : nullptr;
+
+			const uSize minCount = pChild->isLeaf ? LEAF_MIN : INNER_MIN;
+
+			if (pLeftNode && pLeftNode->count > minCount)
+			{
+				// Borrow the last entry of the left sibling
+
+				if (pChild->isLeaf)
+				{
+					Leaf* pLeaf = static_cast<Leaf*>(pChild);
+					Leaf* pLeft = static_cast<Leaf*>(pLeftNode);
+
+					for (uSize i = pLeaf->count; i > 0; i--)
+					{
+						pLeaf->entries[i] = Move(pLeaf->entries[i - 1]);
+					}
+
+					pLeaf->entries[0] = Move(pLeft->entries[pLeft->count - 1]);
+					pLeaf->count++;
+					pLeft->count--;
+
+					pParent->keys[index - 1] = KeyOf(pLeaf->entries[0]);
+				}
+				else
+				{
+					Inner* pInner	= static_cast<Inner*>(pChild);
+					Inner* pLeft	= static_cast<Inner*>(pLeftNode);
+
+					for (uSize i = pInner->count; i > 0; i--)
+					{
+						pInner->keys[i] = Move(pInner->keys[i - 1]);
+					}
+
+					for (uSize i = pInner->count + 1; i > 0; i--)
+					{
+						pInner->pChildren[i] = pInner->pChildren[i - 1];
+					}
+
+					pInner->keys[0]			= Move(pParent->keys[index - 1]);
+					pInner->pChildren[0]	= pLeft->pChildren[pLeft->count];
+					pInner->count++;
+
+					pParent->keys[index - 1] = Move(pLeft->keys[pLeft->count - 1]);
+					pLeft->count--;
+				}
+			}
+			else if (pRightNode && pRightNode->count > minCount)
+			{
+				// Borrow the first entry of the right sibling
+
+				if (pChild->isLeaf)
+				{
+					Leaf* pLeaf		= static_cast<Leaf*>(pChild);
+					Leaf* pRight	= static_cast<Leaf*>(pRightNode);
+
+					pLeaf->entries[pLeaf->count] = Move(pRight->entries[0]);
+					pLeaf->count++;
+
+					for (uSize i = 0; i + 1 < pRight->count; i++)
+					{
+						pRight->entries[i] = Move(pRight->entries[i + 1]);
+					}
+
+					pRight->count--;
+
+					pParent->keys[index] = KeyOf(pRight->entries[0]);
+				}
+				else
+				{
+					Inner* pInner	= static_cast<Inner*>(pChild);
+					Inner* pRight	= static_cast<Inner*>(pRightNode);
+
+					pInner->keys[pInner->count]				= Move(pParent->keys[index]);
+					pInner->pChildren[pInner->count + 1]	= pRight->pChildren[0];
+					pInner->count++;
+
+					pParent->keys[index] = Move(pRight->keys[0]);
+
+					for (uSize i = 0; i + 1 < pRight->count; i++)
+					{
+						pRight->keys[i] = Move(pRight->keys[i + 1]);
+					}
+
+					for (uSize i = 0; i < pRight->count; i++)
+					{
+						pRight->pChildren[i] = pRight->pChildren[i + 1];
+					}
+
+					pRight->count--;
+				}
+			}
+			else if (pLeftNode)
+			{
+				MergeChildren(pParent, index - 1);
+			}
+			else
+			{
+				MergeChildren(pParent, index);
+			}
+		}
+
+		bool RemoveNode(Node* pNode, const KeyType& key)
+		{
+			if (pNode->isLeaf)
+			{
+				Leaf* pLeaf = static_cast<Leaf*>(pNode);
+				const uSize index = LeafLowerBound(pLeaf, key);
+
+				if (index >= pLeaf->count || key < KeyOf(pLeaf->entries[index]))
+				{
+					return false;
+				}
+
+				for (uSize i = index; i + 1 < pLeaf->count; i++)
+				{
+					pLeaf->entries[i] = Move(pLeaf->entries[i + 1]);
+				}
+
+				pLeaf->count--;
+				pLeaf->entries[pLeaf->count] = EntryType();
+
+				return true;
+			}
+
+			Inner* pInner = static_cast<Inner*>(pNode);
+			const uSize childIndex = ChildIndex(pInner, key);
+			Node* pChild = pInner->pChildren[childIndex];
+
+			if (!RemoveNode(pChild, key))
+			{
+				return false;
+			}
+
+			if (pChild->count < (pChild->isLeaf ? LEAF_MIN : INNER_MIN))
+			{
+				Rebalance(pInner, childIndex);
+			}
+
+			return true;
+		}
+
+		template<typename GetEntryFunc>
+		void BuildSortedImpl(uSize count, GetEntryFunc getEntry)
+		{
+			Clear();
+
+			if (count == 0)
+			{
+				return;
+			}
+
+			// Fill leaves evenly, then build each inner level from the one below
+
+			const uSize leafCount = (count + LEAF_CAPACITY - 1) / LEAF_CAPACITY;
+
+			Array<Node*>	level(leafCount);
+			Array<KeyType>	levelMinKeys(leafCount);
+
+			Leaf* pPrevLeaf = nullptr;
+			uSize entryIndex = 0;
+
+			for (uSize i = 0; i < leafCount; i++)
+			{
+				Leaf* pLeaf = new Leaf();
+				const uSize leafSize = count / leafCount + (i < count % leafCount ? 1 : 0);
+
+				for (uSize j = 0; j < leafSize; j++, entryIndex++)
+				{
+					pLeaf->entries[j] = getEntry(entryIndex);
+
+					assert((j > 0 ? KeyOf(pLeaf->entries[j - 1]) < KeyOf(pLeaf->entries[j]) :
+						!pPrevLeaf || KeyOf(pPrevLeaf->entries[pPrevLeaf->count - 1]) < KeyOf(pLeaf->entries[0])) &&
+						"BTree BuildSorted() input must be sorted with unique keys.");
+				}
+
+				pLeaf->count = leafSize;
+				pLeaf->pPrev = pPrevLeaf;
+
+				if (pPrevLeaf)
+				{
+					pPrevLeaf->pNext = pLeaf;
+				}
+
+				pPrevLeaf = pLeaf;
+
+				level[i]		= pLeaf;
+				levelMinKeys[i]	= KeyOf(pLeaf->entries[0]);
+			}
+
+			while (level.Size() > 1)
+			{
+				const uSize childCount	= level.Size();
+				const uSize nodeCount	= (childCount + INNER_CAPACITY) / (INNER_CAPACITY + 1);
+
+				Array<Node*>	parents(nodeCount);
+				Array<KeyType>	parentMinKeys(nodeCount);
+
+				uSize childIndex = 0;
+
+				for (uSize i = 0; i < nodeCount; i++)
+				{
+					Inner* pInner = new Inner();
+					const uSize nodeChildren = childCount / nodeCount + (i < childCount % nodeCount ? 1 : 0);
+
+					parentMinKeys[i] = levelMinKeys[childIndex];
+
+					for (uSize j = 0; j < nodeChildren; j++, childIndex++)
+					{
+						pInner->pChildren[j] = level[childIndex];
+
+						if (j > 0)
+						{
+							pInner->keys[j - 1] = levelMinKeys[childIndex];
+						}
+					}
+
+					pInner->count = nodeChildren - 1;
+					parents[i] = pInner;
+				}
+
+				level			= Move(parents);
+				levelMinKeys	= Move(parentMinKeys);
+			}
+
+			mpRoot	= level[0];
+			mSize	= count;
+		}
+
+		static Node* CopyNode(const Node* pNode, Leaf*& pPrevLeaf)
+		{
+			if (pNode->isLeaf)
+			{
+				const Leaf* pLeaf = static_cast<const Leaf*>(pNode);
+				Leaf* pCopy = new Leaf();
+
+				for (uSize i = 0; i < pLeaf->count; i++)
+				{
+					pCopy->entries[i] = pLeaf->entries[i];
+				}
+
+				pCopy->count = pLeaf->count;
+				pCopy->pPrev = pPrevLeaf;
+
+				if (pPrevLeaf)
+				{
+					pPrevLeaf->pNext = pCopy;
+				}
+
+				pPrevLeaf = pCopy;
+
+				return pCopy;
+			}
+
+			const Inner* pInner = static_cast<const Inner*>(pNode);
+			Inner* pCopy = new Inner();
+
+			for (uSize i = 0; i < pInner->count; i++)
+			{
+				pCopy->keys[i] = pInner->keys[i];
+			}
+
+			for (uSize i = 0; i <= pInner->count; i++)
+			{
+				pCopy->pChildren[i] = CopyNode(pInner->pChildren[i], pPrevLeaf);
+			}
+
+			pCopy->count = pInner->count;
+
+			return pCopy;
+		}
+
+		static void DestroyNode(Node* pNode)
+		{
+			if (pNode->isLeaf)
+			{
+				delete static_cast<Leaf*>(pNode);
+				return;
+			}
+
+			Inner* pInner = static_cast<Inner*>(pNode);
+
+			for (uSize i = 0; i <= pInner->count; i++)
+			{
+				DestroyNode(pInner->pChildren[i]);
+			}
+
+			delete pInner;
+		}
+
+	public:
+		_BTree()
+			: mpRoot(nullptr), mSize(0) {}
+
+		_BTree(const _BTree& tree)
+			: mpRoot(nullptr), mSize(tree.mSize)
+		{
+			if (tree.mpRoot)
+			{
+				Leaf* pPrevLeaf = nullptr;
+				mpRoot = CopyNode(tree.mpRoot, pPrevLeaf);
+			}
+		}
+
+		_BTree(_BTree&& tree) noexcept
+			: _BTree()
+		{
+			Swap(*this, tree);
+		}
+
+		~_BTree()
+		{
+			Clear();
+		}
+
+		/* Removes key, returns false if it was not found */
+		bool Remove(const KeyType& key)
+		{
+			if (!mpRoot || !RemoveNode(mpRoot, key))
+			{
+				return false;
+			}
+
+			mSize--;
+
+			if (mpRoot->count == 0)
+			{
+				Node* pOldRoot = mpRoot;
+
+				if (mpRoot->isLeaf)
+				{
+					mpRoot = nullptr;
+					delete static_cast<Leaf*>(pOldRoot);
+				}
+				else
+				{
+					mpRoot = static_cast<Inner*>(pOldRoot)->pChildren[0];
+					delete static_cast<Inner*>(pOldRoot);
+				}
+			}
+
+			return true;
+		}
+
+		Iterator Find(const KeyType& key)
+		{
+			return FindImpl(key);
+		}
+
+		ConstIterator Find(const KeyType& key) const
+		{
+			return FindImpl(key);
+		}
+
+		bool Contains(const KeyType& key) const
+		{
+			return FindImpl(key) != End();
+		}
+
+		/* Returns the first entry with a key not less than key */
+		Iterator LowerBound(const KeyType& key)
+		{
+			Leaf* pLeaf = FindLeaf(key);
+			return Normalize(pLeaf, pLeaf ? LeafLowerBound(pLeaf, key) : 0);
+		}
+
+		ConstIterator LowerBound(const KeyType& key) const
+		{
+			return const_cast<_BTree*>(this)->LowerBound(key);
+		}
+
+		/* Returns the first entry with a key greater than key */
+		Iterator UpperBound(const KeyType& key)
+		{
+			Leaf* pLeaf = FindLeaf(key);
+			return Normalize(pLeaf, pLeaf ? LeafUpperBound(pLeaf, key) : 0);
+		}
+
+		ConstIterator UpperBound(const KeyType& key) const
+		{
+			return const_cast<_BTree*>(this)->UpperBound(key);
+		}
+
+		/* Returns the entries with keys in [low, high) */
+		BTreeRange<Iterator> Range(const KeyType& low, const KeyType& high)
+		{
+			Iterator first = LowerBound(low);
+			Iterator last = LowerBound(high);
+
+			return (high < low) ? BTreeRange<Iterator>(first, first) : BTreeRange<Iterator>(first, last);
+		}
+
+		BTreeRange<ConstIterator> Range(const KeyType& low, const KeyType& high) const
+		{
+			BTreeRange<Iterator> range = const_cast<_BTree*>(this)->Range(low, high);
+			return BTreeRange<ConstIterator>(range.Begin(), range.End());
+		}
+
+		Iterator Begin()
+		{
+			Node* pNode = mpRoot;
+
+			while (pNode && !pNode->isLeaf)
+			{
+				pNode = static_cast<Inner*>(pNode)->pChildren[0];
+			}
+
+			return Iterator(static_cast<Leaf*>(pNode), 0);
+		}
+
+		ConstIterator Begin() const
+		{
+			return const_cast<_BTree*>(this)->Begin();
+		}
+
+		Iterator End()
+		{
+			return Iterator();
+		}
+
+		ConstIterator End() const
+		{
+			return ConstIterator();
+		}
+
+		/* Returns the entry with the greatest key, or End() if empty */
+		Iterator Last()
+		{
+			Node* pNode = mpRoot;
+
+			while (pNode && !pNode->isLeaf)
+			{
+				Inner* pInner = static_cast<Inner*>(pNode);
+				pNode = pInner->pChildren[pInner->count];
+			}
+
+			return pNode ? Iterator(static_cast<Leaf*>(pNode), pNode->count - 1) : Iterator();
+		}
+
+		ConstIterator Last() const
+		{
+			return const_cast<_BTree*>(this)->Last();
+		}
+
+		void Clear()
+		{
+			if (mpRoot)
+			{
+				DestroyNode(mpRoot);
+			}
+
+			mpRoot	= nullptr;
+			mSize	= 0;
+		}
+
+		uSize Size() const
+		{
+			return mSize;
+		}
+
+		bool IsEmpty() const
+		{
+			return mSize == 0;
+		}
+
+		_BTree& operator=(_BTree tree)
+		{
+			Swap(*this, tree);
+			return *this;
+		}
+
+		// for-each functions:
+
+		Iterator begin()
+		{
+			return Begin();
+		}
+
+		Iterator end()
+		{
+			return End();
+		}
+
+		ConstIterator begin() const
+		{
+			return Begin();
+		}
+
+		ConstIterator end() const
+		{
+			return End();
+		}
+	};
+
+	/* An ordered map based on a B+ tree, see _BTree */
+	template<typename KeyType, typename ValueType>
+	class BTreeMap : public _BTree<KeyType, MapPair<KeyType, ValueType>, _BTreeMapKeyOf>
+	{
+	public:
+		using PairType = MapPair<KeyType, ValueType>;
+
+	public:
+		BTreeMap() = default;
+
+		/* Builds the map from keys sorted in ascending order with no duplicates */
+		BTreeMap(const KeyType* pKeys, const ValueType* pValues, uSize count)
+		{
+			BuildSorted(pKeys, pValues, count);
+		}
+
+		/* Puts a value, replacing any existing value of key */
+		template<typename RKeyType, typename RValueType>
+		ValueType& Put(RKeyType&& key, RValueType&& value)
+		{
+			PairType pair(Forward<RKeyType>(key), Forward<RValueType>(value));
+			bool inserted;
+
+			return this->InsertImpl(pair, true, inserted).value;
+		}
+
+		/* Gets the value of key, default-inserting it if not found */
+		template<typename RKeyType>
+		ValueType& Get(RKeyType&& key)
+		{
+			typename BTreeMap::Iterator it = this->Find(key);
+
+			if (it != this->End())
+			{
+				return it->value;
+			}
+
+			PairType pair(Forward<RKeyType>(key));
+			bool inserted;
+
+			return this->InsertImpl(pair, false, inserted).value;
+		}
+
+		/* Replaces the contents with keys sorted in ascending order with no duplicates */
+		void BuildSorted(const KeyType* pKeys, const ValueType* pValues, uSize count)
+		{
+			this->BuildSortedImpl(count,
+				[&](uSize i) { return PairType(pKeys[i], pValues[i]); });
+		}
+
+		template<typename RKeyType>
+		ValueType& operator[](RKeyType&& key)
+		{
+			return Get(Forward<RKeyType>(key));
+		}
+	};
+
+	/* An ordered set based on a B+ tree, see _BTree */
+	template<typename KeyType>
+	class BTreeSet : public _BTree<KeyType, KeyType, _BTreeSetKeyOf>
+	{
+	public:
+		BTreeSet() = default;
+
+		/* Builds the set from keys sorted in ascending order with no duplicates */
+		BTreeSet(const KeyType* pKeys, uSize count)
+		{
+			BuildSorted(pKeys, count);
+		}
+
+		/* Adds key, returns false if it was already in the set */
+		template<typename RKeyType>
+		bool Add(RKeyType&& key)
+		{
+			KeyType value(Forward<RKeyType>(key));
+			bool inserted;
+
+			this->InsertImpl(value, false, inserted);
+
+			return inserted;
+		}
+
+		/* Replaces the contents with keys sorted in ascending order with no duplicates */
+		void BuildSorted(const KeyType* pKeys, uSize count)
+		{
+			this->BuildSortedImpl(count,
+				[&](uSize i) -> const KeyType& { return pKeys[i]; });
+		}
+	};
+}
\ No newline at end of file
@@ -0,0 +1,209 @@
+#pragma once
+
+#include "Types.h"
+#include "Array.h"
+#include "Utility/Hash.h"
+#include "Utility/Swap.h"
+
+#include <cmath>
+
+namespace Quartz
+{
+	/*====================================================
+	|               QUARTZLIB BLOOM FILTER               |
+	=====================================================*/
+
+	/* One cache line of filter bits */
+	struct alignas(64) BloomBlock
+	{
+		uInt64 words[8];
+
+		BloomBlock()
+			: words() {}
+	};
+
+	/*
+		A blocked Bloom filter. Each key selects one 64-byte block and sets
+		all of its bits within that block, so an add or query touches a
+		single cache line. Queries build the key's 512-bit mask and test the
+		whole block at once with a branchless loop the compiler vectorizes.
+
+		MayContain() never returns false for an added key, and returns true
+		for other keys at about the false positive rate the filter was sized
+		for. Keys are hashed with HashLookup, see AddHash() to reuse a hash
+		already computed for a Map lookup.
+	*/
+	class BloomFilter
+	{
+	public:
+		constexpr static uSize	BLOCK_BITS			= 512;
+		constexpr static uSize	MAX_HASH_COUNT		= 16;
+		constexpr static double	BLOCKING_OVERHEAD	= 1.2;
+
+	private:
+		Array<BloomBlock>	mBlocks;
+		uSize				mHashCount;
+
+	private:
+		friend void Swap(BloomFilter& filter1, BloomFilter& filter2)
+		{
+			using Quartz::Swap;
+			Swap(filter1.mBlocks, filter2.mBlocks);
+			Swap(filter1.mHashCount, filter2.mHashCount);
+		}
+
+		BloomBlock& BlockOf(hash64 hash)
+		{
+			return mBlocks[static_cast<uSize>(hash % mBlocks.Size())];
+		}
+
+		const BloomBlock& BlockOf(hash64 hash) const
+		{
+			return mBlocks[static_cast<uSize>(hash % mBlocks.Size())];
+		}
+
+		/* Builds the in-block bit mask of a hash using double hashing */
+		void MaskOf(hash64 hash, BloomBlock& mask) const
+		{
+			const hash64 bitHash = Hash<uInt64>(hash);
+			const uInt32 hash1 = static_cast<uInt32>(bitHash);
+			const uInt32 hash2 = static_cast<uInt32>(bitHash >> 32) | 1;
+
+			for (uSize i = 0; i < mHashCount; i++)
+			{
+				const uInt32 bit = (hash1 + static_cast<uInt32>(i) * hash2) % BLOCK_BITS;
+				mask.words[bit / 64] |= uInt64(1) << (bit % 64);
+			}
+		}
+
+	public:
+		BloomFilter()
+			: mBlocks(), mHashCount(0) {}
+
+		/* Sizes the filter for expectedCount keys at the given false positive rate */
+		BloomFilter(uSize expectedCount, float falsePositiveRate = 0.01f)
+			: BloomFilter()
+		{
+			const double ln2 = 0.69314718055994530942;
+			const double rate = falsePositiveRate > 0.0f && falsePositiveRate < 1.0f ? falsePositiveRate : 0.01;
+			const double bitsPerKey = -std::log(rate) / (ln2 * ln2);
+
+			const uSize hashCount = static_cast<uSize>(bitsPerKey * ln2 + 0.5);
+			mHashCount = hashCount < 1 ? 1 : hashCount > MAX_HASH_COUNT ? MAX_HASH_COUNT : hashCount;
+
+			// Blocking skews the bit load between blocks, which costs some
+			// accuracy over a classic filter, so the bit count is padded
+			const double totalBits = BLOCKING_OVERHEAD * bitsPerKey * (expectedCount > 0 ? expectedCount : 1);
+			const uSize blockCount = static_cast<uSize>(std::ceil(totalBits / BLOCK_BITS));
+
+			mBlocks = Array<BloomBlock>(blockCount > 0 ? blockCount : 1);
+		}
+
+		BloomFilter(const BloomFilter& filter)
+			: mBlocks(filter.mBlocks), mHashCount(filter.mHashCount) {}
+
+		BloomFilter(BloomFilter&& filter) noexcept
+			: BloomFilter()
+		{
+			Swap(*this, filter);
+		}
+
+		template<typename KeyType>
+		void Add(const KeyType& key)
+		{
+			AddHash(HashLookup<KeyType>(key));
+		}
+
+		/* Adds a key by its HashLookup() hash */
+		void AddHash(hash64 hash)
+		{
+			BloomBlock mask;
+			MaskOf(hash, mask);
+
+			BloomBlock& block = BlockOf(hash);
+
+			for (uSize i = 0; i < 8; i++)
+			{
+				block.words[i] |= mask.words[i];
+			}
+		}
+
+		template<typename KeyType>
+		bool MayContain(const KeyType& key) const
+		{
+			return MayContainHash(HashLookup<KeyType>(key));
+		}
+
+		bool MayContainHash(hash64 hash) const
+		{
+			if (mBlocks.IsEmpty())
+			{
+				return false;
+			}
+
+			BloomBlock mask;
+			MaskOf(hash, mask);
+
+			const BloomBlock& block = BlockOf(hash);
+			uInt64 missing = 0;
+
+			for (uSize i = 0; i < 8; i++)
+			{
+				missing |= mask.words[i] & ~block.words[i];
+			}
+
+			return missing == 0;
+		}
+
+		/*
+			Adds all keys of filter, which must have been constructed
+			with the same parameters. Returns false if they differ.
+		*/
+		bool Merge(const BloomFilter& filter)
+		{
+			if (filter.mBlocks.Size() != mBlocks.Size() || filter.mHashCount != mHashCount)
+			{
+				return false;
+			}
+
+			for (uSize i = 0; i < mBlocks.Size(); i++)
+			{
+				for (uSize j = 0; j < 8; j++)
+				{
+					mBlocks[i].words[j] |= filter.mBlocks[i].words[j];
+				}
+			}
+
+			return true;
+		}
+
+		void Clear()
+		{
+			for (uSize i = 0; i < mBlocks.Size(); i++)
+			{
+				mBlocks[i] = BloomBlock();
+			}
+		}
+
+		uSize HashCount() const
+		{
+			return mHashCount;
+		}
+
+		uSize BlockCount() const
+		{
+			return mBlocks.Size();
+		}
+
+		uSize SizeBytes() const
+		{
+			return mBlocks.Size() * sizeof(BloomBlock);
+		}
+
+		BloomFilter& operator=(BloomFilter filter)
+		{
+			Swap(*this, filter);
+			return *this;
+		}
+	};
+}
\ No newline at end of file
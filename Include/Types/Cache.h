@@ -0,0 +1,716 @@
+#pragma once
+
+#include "Map.h"
+#include "Set.h"
+#include "Array.h"
+
+namespace Quartz
+{
+	/*====================================================
+	|                   QUARTZLIB CACHE                  |
+	=====================================================*/
+
+	/* Hit and miss counters of a cache, see LruCache::GetStats() */
+	struct CacheStats
+	{
+		uInt64 hits;
+		uInt64 misses;
+		uInt64 insertions;
+		uInt64 evictions;
+	};
+
+	constexpr uSize CACHE_NULL_SLOT = static_cast<uSize>(-1);
+
+	/* A cache entry, linked into its recency list by slot index */
+	template<typename KeyType, typename ValueType>
+	struct _CacheSlot
+	{
+		KeyType		key;
+		ValueType	value;
+		hash64		hash;
+		uSize		cost;
+		uSize		prev;
+		uSize		next;
+		uInt8		freq;
+		uInt8		queue;
+
+		_CacheSlot()
+			: key(), value(), hash(0), cost(0), prev(CACHE_NULL_SLOT),
+			next(CACHE_NULL_SLOT), freq(0), queue(0) {}
+	};
+
+	/* A doubly linked list threaded through a slot Array, head first */
+	struct _CacheList
+	{
+		uSize head;
+		uSize tail;
+		uSize cost;
+
+		_CacheList()
+			: head(CACHE_NULL_SLOT), tail(CACHE_NULL_SLOT), cost(0) {}
+
+		template<typename SlotType>
+		void PushFront(Array<SlotType>& slots, uSize index)
+		{
+			SlotType& slot = slots[index];
+
+			slot.prev = CACHE_NULL_SLOT;
+			slot.next = head;
+
+			if (head != CACHE_NULL_SLOT)
+			{
+				slots[head].prev = index;
+			}
+			else
+			{
+				tail = index;
+			}
+
+			head = index;
+			cost += slot.cost;
+		}
+
+		template<typename SlotType>
+		void Unlink(Array<SlotType>& slots, uSize index)
+		{
+			SlotType& slot = slots[index];
+
+			if (slot.prev != CACHE_NULL_SLOT)
+			{
+				slots[slot.prev].next = slot.next;
+			}
+			else
+			{
+				head = slot.next;
+			}
+
+			if (slot.next != CACHE_NULL_SLOT)
+			{
+				slots[slot.next].prev = slot.prev;
+			}
+			else
+			{
+				tail = slot.prev;
+			}
+
+			slot.prev = CACHE_NULL_SLOT;
+			slot.next = CACHE_NULL_SLOT;
+			cost -= slot.cost;
+		}
+
+		bool IsEmpty() const
+		{
+			return head == CACHE_NULL_SLOT;
+		}
+	};
+
+	/*
+		The storage shared by the caches: a Map from each key to a slot in
+		one contiguous Array. Freed slots are reused, so slot indices (and
+		the recency links between them) stay valid while the Map rehashes.
+	*/
+	template<typename KeyType, typename ValueType, typename HashType, typename PolicyType>
+	class _CacheBase
+	{
+	public:
+		using SlotType		= _CacheSlot<KeyType, ValueType>;
+		using IndexMapType	= Map<KeyType, uSize, HashType, PolicyType>;
+
+	protected:
+		IndexMapType	mIndex;
+		Array<SlotType>	mSlots;
+		uSize			mFreeHead;
+		uSize			mCapacity;
+		CacheStats		mStats;
+
+	protected:
+		friend void Swap(_CacheBase& cache1, _CacheBase& cache2)
+		{
+			using Quartz::Swap;
+			Swap(cache1.mIndex, cache2.mIndex);
+			Swap(cache1.mSlots, cache2.mSlots);
+			Swap(cache1.mFreeHead, cache2.mFreeHead);
+			Swap(cache1.mCapacity, cache2.mCapacity);
+			Swap(cache1.mStats, cache2.mStats);
+		}
+
+		_CacheBase(uSize capacity)
+			: mIndex(), mSlots(), mFreeHead(CACHE_NULL_SLOT), mCapacity(capacity), mStats() {}
+
+		_CacheBase(const _CacheBase& cache)
+			: mIndex(cache.mIndex), mSlots(cache.mSlots), mFreeHead(cache.mFreeHead),
+			mCapacity(cache.mCapacity), mStats(cache.mStats) {}
+
+		template<typename LookupType>
+		uSize FindSlot(const LookupType& key) const
+		{
+			typename IndexMapType::ConstIterator it = mIndex.Find(key);
+			return it == mIndex.End() ? CACHE_NULL_SLOT : it->value;
+		}
+
+		/* Stores a new key and value in a free slot and indexes it */
+		template<typename RKeyType, typename RValueType>
+		uSize AllocSlot(hash64 hash, RKeyType&& key, RValueType&& value, uSize cost)
+		{
+			uSize index = mFreeHead;
+
+			if (index != CACHE_NULL_SLOT)
+			{
+				mFreeHead = mSlots[index].next;
+			}
+			else
+			{
+				index = mSlots.Size();
+				mSlots.PushBack(SlotType());
+			}
+
+			SlotType& slot = mSlots[index];
+			slot.key	= Forward<RKeyType>(key);
+			slot.value	= Forward<RValueType>(value);
+			slot.hash	= hash;
+			slot.cost	= cost;
+			slot.freq	= 0;
+			slot.queue	= 0;
+
+			mIndex.Put(hash, slot.key, index);
+			mStats.insertions++;
+
+			return index;
+		}
+
+		/* Unindexes an unlinked slot and returns it to the free list */
+		void FreeSlot(uSize index)
+		{
+			SlotType& slot = mSlots[index];
+
+			mIndex.Remove(slot.hash, slot.key);
+
+			slot.key	= KeyType();
+			slot.value	= ValueType();
+			slot.next	= mFreeHead;
+			mFreeHead	= index;
+		}
+
+		void ClearSlots()
+		{
+			mIndex.Clear();
+			mSlots		= Array<SlotType>();
+			mFreeHead	= CACHE_NULL_SLOT;
+		}
+
+		template<typename RKeyType>
+		hash64 HashOf(const RKeyType& key) const
+		{
+			return static_cast<HashType>(HashSeeded<KeyType>(key, mIndex.Seed()));
+		}
+
+	public:
+		template<typename LookupType>
+		bool Contains(const LookupType& key) const
+		{
+			return mIndex.Contains(key);
+		}
+
+		/* Returns the value of key without counting a hit or updating its recency */
+		template<typename LookupType>
+		const ValueType* Peek(const LookupType& key) const
+		{
+			const uSize index = FindSlot(key);
+			return index == CACHE_NULL_SLOT ? nullptr : &mSlots[index].value;
+		}
+
+		/* Rehashes the keys with a new seed, see Map::SetSeed() */
+		void SetSeed(hash64 seed)
+		{
+			mIndex.SetSeed(seed);
+
+			for (uSize i = 0; i < mSlots.Size(); i++)
+			{
+				mSlots[i].hash = HashOf(mSlots[i].key);
+			}
+		}
+
+		uSize Size() const
+		{
+			return mIndex.Size();
+		}
+
+		bool IsEmpty() const
+		{
+			return mIndex.IsEmpty();
+		}
+
+		uSize Capacity() const
+		{
+			return mCapacity;
+		}
+
+		const CacheStats& GetStats() const
+		{
+			return mStats;
+		}
+
+		void ResetStats()
+		{
+			mStats = CacheStats();
+		}
+	};
+
+	/*
+		A bounded least-recently-used cache.
+
+		Each entry has a cost, 1 by default, so the capacity can count
+		entries or, by passing sizes to Put(), bytes. Once the total cost
+		exceeds the capacity the least recently used entries are evicted.
+
+		Entries live in one contiguous slot Array linked into a recency
+		list by index, so unlike Map plus List there is no allocation per
+		entry, and a hit is a single Map lookup followed by O(1) relinking.
+
+		Note: Pointers returned by Find() are invalidated by Put().
+	*/
+	template<typename KeyType, typename ValueType, typename HashType = uSize, typename PolicyType = TablePolicy>
+	class LruCache : public _CacheBase<KeyType, ValueType, HashType, PolicyType>
+	{
+	public:
+		using BaseType = _CacheBase<KeyType, ValueType, HashType, PolicyType>;
+
+	private:
+		_CacheList mList;
+
+	private:
+		friend void Swap(LruCache& cache1, LruCache& cache2)
+		{
+			using Quartz::Swap;
+			Swap(static_cast<BaseType&>(cache1), static_cast<BaseType&>(cache2));
+			Swap(cache1.mList, cache2.mList);
+		}
+
+		/* Evicts from the tail until within capacity, never evicting keep */
+		void EvictOver(uSize extraCost, uSize keep)
+		{
+			while (mList.cost + extraCost > this->mCapacity &&
+				mList.tail != CACHE_NULL_SLOT && mList.tail != keep)
+			{
+				const uSize victim = mList.tail;
+
+				mList.Unlink(this->mSlots, victim);
+				this->FreeSlot(victim);
+				this->mStats.evictions++;
+			}
+		}
+
+	public:
+		LruCache()
+			: BaseType(0), mList() {}
+
+		LruCache(uSize capacity)
+			: BaseType(capacity), mList() {}
+
+		LruCache(const LruCache& cache)
+			: BaseType(cache), mList(cache.mList) {}
+
+		LruCache(LruCache&& cache) noexcept
+			: LruCache()
+		{
+			Swap(*this, cache);
+		}
+
+		/* Returns the value of key and marks it most recently used, or nullptr on a miss */
+		template<typename LookupType>
+		ValueType* Find(const LookupType& key)
+		{
+			const uSize index = this->FindSlot(key);
+
+			if (index == CACHE_NULL_SLOT)
+			{
+				this->mStats.misses++;
+				return nullptr;
+			}
+
+			this->mStats.hits++;
+
+			if (mList.head != index)
+			{
+				mList.Unlink(this->mSlots, index);
+				mList.PushFront(this->mSlots, index);
+			}
+
+			return &this->mSlots[index].value;
+		}
+
+		/*
+			Inserts or replaces the value of key as the most recently used
+			entry, evicting others to fit its cost. An entry costing more
+			than the whole capacity is kept until the next Put().
+		*/
+		template<typename RKeyType, typename RValueType>
+		ValueType& Put(RKeyType&& key, RValueType&& value, uSize cost = 1)
+		{
+			const hash64 hash = this->HashOf(key);
+			typename BaseType::IndexMapType::Iterator it = this->mIndex.Find(hash, key);
+
+			if (it != this->mIndex.End())
+			{
+				const uSize index = it->value;
+
+				mList.Unlink(this->mSlots, index);
+				this->mSlots[index].value	= Forward<RValueType>(value);
+				this->mSlots[index].cost	= cost;
+				mList.PushFront(this->mSlots, index);
+
+				EvictOver(0, index);
+
+				return this->mSlots[index].value;
+			}
+
+			EvictOver(cost, CACHE_NULL_SLOT);
+
+			const uSize index = this->AllocSlot(hash, Forward<RKeyType>(key), Forward<RValueType>(value), cost);
+			mList.PushFront(this->mSlots, index);
+
+			return this->mSlots[index].value;
+		}
+
+		/* Removes key, returns false if it was not cached */
+		template<typename LookupType>
+		bool Remove(const LookupType& key)
+		{
+			const uSize index = this->FindSlot(key);
+
+			if (index == CACHE_NULL_SLOT)
+			{
+				return false;
+			}
+
+			mList.Unlink(this->mSlots, index);
+			this->FreeSlot(index);
+
+			return true;
+		}
+
+		/* Changes the capacity, evicting entries that no longer fit */
+		void SetCapacity(uSize capacity)
+		{
+			this->mCapacity = capacity;
+			EvictOver(0, CACHE_NULL_SLOT);
+		}
+
+		/* Calls func(key, value) for every entry, most recently used first */
+		template<typename Func>
+		void ForEach(Func func) const
+		{
+			for (uSize index = mList.head; index != CACHE_NULL_SLOT; index = this->mSlots[index].next)
+			{
+				func(this->mSlots[index].key, this->mSlots[index].value);
+			}
+		}
+
+		void Clear()
+		{
+			this->ClearSlots();
+			mList = _CacheList();
+		}
+
+		/* Returns the total cost of all entries */
+		uSize Cost() const
+		{
+			return mList.cost;
+		}
+
+		LruCache& operator=(LruCache cache)
+		{
+			Swap(*this, cache);
+			return *this;
+		}
+	};
+
+	/*
+		A bounded cache using S3-FIFO eviction, a CLOCK-like policy that
+		resists scans better than LRU and does no relinking on a hit.
+
+		New keys enter a small FIFO holding about SMALL_RATIO of the
+		capacity. Keys hit while in it are promoted to the main FIFO when
+		they reach its end, while the rest are evicted and remembered by
+		hash in a ghost FIFO, so that they enter the main FIFO directly if
+		they return soon. Main FIFO entries are reinserted CLOCK-style while
+		their hit counter, capped at MAX_FREQUENCY, counts down.
+
+		Costs and capacity work as in LruCache. The ghost FIFO remembers
+		ghostCount keys, the capacity by default.
+
+		Note: Pointers returned by Find() are invalidated by Put().
+	*/
+	template<typename KeyType, typename ValueType, typename HashType = uSize, typename PolicyType = TablePolicy>
+	class S3FifoCache : public _CacheBase<KeyType, ValueType, HashType, PolicyType>
+	{
+	public:
+		using BaseType = _CacheBase<KeyType, ValueType, HashType, PolicyType>;
+
+		constexpr static float SMALL_RATIO		= 0.1f;
+		constexpr static uInt8 MAX_FREQUENCY	= 3;
+
+	private:
+		constexpr static uInt8 SMALL_QUEUE	= 0;
+		constexpr static uInt8 MAIN_QUEUE	= 1;
+
+		_CacheList		mSmall;
+		_CacheList		mMain;
+		Set<hash64>		mGhosts;
+		Array<hash64>	mGhostRing;
+		uSize			mGhostNext;
+		uSize			mGhostCount;
+
+	private:
+		friend void Swap(S3FifoCache& cache1, S3FifoCache& cache2)
+		{
+			using Quartz::Swap;
+			Swap(static_cast<BaseType&>(cache1), static_cast<BaseType&>(cache2));
+			Swap(cache1.mSmall, cache2.mSmall);
+			Swap(cache1.mMain, cache2.mMain);
+			Swap(cache1.mGhosts, cache2.mGhosts);
+			Swap(cache1.mGhostRing, cache2.mGhostRing);
+			Swap(cache1.mGhostNext, cache2.mGhostNext);
+			Swap(cache1.mGhostCount, cache2.mGhostCount);
+		}
+
+		_CacheList& QueueOf(uSize index)
+		{
+			return this->mSlots[index].queue == SMALL_QUEUE ? mSmall : mMain;
+		}
+
+		void AddGhost(hash64 hash)
+		{
+			if (mGhostCount == 0 || mGhosts.Contains(hash))
+			{
+				return;
+			}
+
+			if (mGhostRing.Size() < mGhostCount)
+			{
+				mGhostRing.PushBack(hash);
+			}
+			else
+			{
+				// Overwrite the oldest ghost
+				mGhosts.Remove(mGhostRing[mGhostNext]);
+				mGhostRing[mGhostNext] = hash;
+				mGhostNext = (mGhostNext + 1) % mGhostCount;
+			}
+
+			mGhosts.Add(hash);
+		}
+
+		/* Frees the small FIFO's oldest entry, or promotes it if it was hit */
+		void EvictSmall(uSize keep)
+		{
+			const uSize index = mSmall.tail;
+			mSmall.Unlink(this->mSlots, index);
+
+			if (this->mSlots[index].freq > 0 || index == keep)
+			{
+				this->mSlots[index].freq	= 0;
+				this->mSlots[index].queue	= MAIN_QUEUE;
+				mMain.PushFront(this->mSlots, index);
+				return;
+			}
+
+			AddGhost(this->mSlots[index].hash);
+			this->FreeSlot(index);
+			this->mStats.evictions++;
+		}
+
+		/* Frees the main FIFO's oldest entry, or reinserts it if its counter is set */
+		void EvictMain(uSize keep)
+		{
+			const uSize index = mMain.tail;
+			mMain.Unlink(this->mSlots, index);
+
+			if (this->mSlots[index].freq > 0 || index == keep)
+			{
+				if (this->mSlots[index].freq > 0)
+				{
+					this->mSlots[index].freq--;
+				}
+
+				mMain.PushFront(this->mSlots, index);
+				return;
+			}
+
+			this->FreeSlot(index);
+			this->mStats.evictions++;
+		}
+
+		/* Evicts until within capacity, never evicting keep */
+		void EvictOver(uSize extraCost, uSize keep)
+		{
+			const uSize smallTarget = static_cast<uSize>(this->mCapacity * SMALL_RATIO);
+
+			while (mSmall.cost + mMain.cost + extraCost > this->mCapacity && !IsOnly(keep))
+			{
+				const bool mainIsKeep = mMain.head == keep && mMain.tail == keep;
+
+				if (!mSmall.IsEmpty() && (mSmall.cost > smallTarget || mMain.IsEmpty() || mainIsKeep))
+				{
+					EvictSmall(keep);
+				}
+				else
+				{
+					EvictMain(keep);
+				}
+			}
+		}
+
+		bool IsOnly(uSize keep) const
+		{
+			return this->IsEmpty() || (this->Size() == 1 && keep != CACHE_NULL_SLOT);
+		}
+
+	public:
+		S3FifoCache()
+			: BaseType(0), mSmall(), mMain(), mGhosts(), mGhostRing(), mGhostNext(0), mGhostCount(0) {}
+
+		S3FifoCache(uSize capacity)
+			: S3FifoCache(capacity, capacity) {}
+
+		S3FifoCache(uSize capacity, uSize ghostCount)
+			: BaseType(capacity), mSmall(), mMain(), mGhosts(), mGhostRing(), mGhostNext(0),
+			mGhostCount(ghostCount) {}
+
+		S3FifoCache(const S3FifoCache& cache)
+			: BaseType(cache), mSmall(cache.mSmall), mMain(cache.mMain), mGhosts(cache.mGhosts),
+			mGhostRing(cache.mGhostRing), mGhostNext(cache.mGhostNext), mGhostCount(cache.mGhostCount) {}
+
+		S3FifoCache(S3FifoCache&& cache) noexcept
+			: S3FifoCache()
+		{
+			Swap(*this, cache);
+		}
+
+		/* Returns the value of key and counts a hit on it, or nullptr on a miss */
+		template<typename LookupType>
+		ValueType* Find(const LookupType& key)
+		{
+			const uSize index = this->FindSlot(key);
+
+			if (index == CACHE_NULL_SLOT)
+			{
+				this->mStats.misses++;
+				return nullptr;
+			}
+
+			this->mStats.hits++;
+
+			uInt8& freq = this->mSlots[index].freq;
+			freq = freq < MAX_FREQUENCY ? freq + 1 : MAX_FREQUENCY;
+
+			return &this->mSlots[index].value;
+		}
+
+		/*
+			Inserts or replaces the value of key, evicting others to fit
+			its cost. Replacing a value counts as a hit on the entry.
+		*/
+		template<typename RKeyType, typename RValueType>
+		ValueType& Put(RKeyType&& key, RValueType&& value, uSize cost = 1)
+		{
+			const hash64 hash = this->HashOf(key);
+			typename BaseType::IndexMapType::Iterator it = this->mIndex.Find(hash, key);
+
+			if (it != this->mIndex.End())
+			{
+				const uSize index = it->value;
+				_CacheList& queue = QueueOf(index);
+
+				queue.Unlink(this->mSlots, index);
+				this->mSlots[index].value	= Forward<RValueType>(value);
+				this->mSlots[index].cost	= cost;
+				queue.PushFront(this->mSlots, index);
+
+				uInt8& freq = this->mSlots[index].freq;
+				freq = freq < MAX_FREQUENCY ? freq + 1 : MAX_FREQUENCY;
+
+				EvictOver(0, index);
+
+				return this->mSlots[index].value;
+			}
+
+			EvictOver(cost, CACHE_NULL_SLOT);
+
+			const bool ghost = mGhosts.Contains(hash);
+
+			if (ghost)
+			{
+				mGhosts.Remove(hash);
+			}
+
+			const uSize index = this->AllocSlot(hash, Forward<RKeyType>(key), Forward<RValueType>(value), cost);
+
+			this->mSlots[index].queue = ghost ? MAIN_QUEUE : SMALL_QUEUE;
+			QueueOf(index).PushFront(this->mSlots, index);
+
+			return this->mSlots[index].value;
+		}
+
+		/* Removes key, returns false if it was not cached */
+		template<typename LookupType>
+		bool Remove(const LookupType& key)
+		{
+			const uSize index = this->FindSlot(key);
+
+			if (index == CACHE_NULL_SLOT)
+			{
+				return false;
+			}
+
+			QueueOf(index).Unlink(this->mSlots, index);
+			this->FreeSlot(index);
+
+			return true;
+		}
+
+		/* Changes the capacity, evicting entries that no longer fit */
+		void SetCapacity(uSize capacity)
+		{
+			this->mCapacity = capacity;
+			EvictOver(0, CACHE_NULL_SLOT);
+		}
+
+		/* Calls func(key, value) for every entry */
+		template<typename Func>
+		void ForEach(Func func) const
+		{
+			for (uSize index = mSmall.head; index != CACHE_NULL_SLOT; index = this->mSlots[index].next)
+			{
+				func(this->mSlots[index].key, this->mSlots[index].value);
+			}
+
+			for (uSize index = mMain.head; index != CACHE_NULL_SLOT; index = this->mSlots[index].next)
+			{
+				func(this->mSlots[index].key, this->mSlots[index].value);
+			}
+		}
+
+		void Clear()
+		{
+			this->ClearSlots();
+			mSmall		= _CacheList();
+			mMain		= _CacheList();
+			mGhosts		= Set<hash64>();
+			mGhostRing	= Array<hash64>();
+			mGhostNext	= 0;
+		}
+
+		/* Returns the total cost of all entries */
+		uSize Cost() const
+		{
+			return mSmall.cost + mMain.cost;
+		}
+
+		S3FifoCache& operator=(S3FifoCache cache)
+		{
+			Swap(*this, cache);
+			return *this;
+		}
+	};
+}
\ No newline at end of file
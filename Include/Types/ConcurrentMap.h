@@ -0,0 +1,450 @@
+#pragma once
+
+#include "Map.h"
+#include "Array.h"
+#include "Utility/SpinLock.h"
+
+#include <atomic>
+#include <type_traits>
+
+namespace Quartz
+{
+	/*====================================================
+	|              QUARTZLIB CONCURRENT MAP              |
+	=====================================================*/
+
+	/*
+		A thread-safe hash-map striped across SHARD_COUNT independent Tables.
+		Writes lock their own shard only, and a shard resizes without
+		stalling the rest of the map.
+
+		When KeyType and ValueType are trivially copyable, lookups take no
+		lock and write nothing shared. Each shard is a seqlock: writers make
+		its version odd while they change the table, and a lookup retries
+		if the version it read before probing was odd or has changed since.
+		A shard never rehashes in place, it publishes a grown copy of its
+		table instead, so a lookup racing a resize probes the old table
+		safely. Outgrown tables are freed with the map, which keeps at most
+		as much memory again as the current tables, as each is at least
+		twice the size of the one it replaced.
+
+		Other key and value types cannot be copied safely while a writer
+		changes them, so their lookups take the shard lock shared instead.
+
+		Note: Values are copied out of the map, as references into a shard
+		are not stable once its lock is released. Use Update() to modify
+		a value in place.
+	*/
+	template<typename KeyType, typename ValueType, uSize SHARD_COUNT = 64, typename HashType = uSize>
+	class ConcurrentMap
+	{
+	public:
+		using PairType	= MapPair<KeyType, ValueType>;
+		using TableType	= Table<PairType, HashType>;
+
+		static_assert(SHARD_COUNT > 0 && (SHARD_COUNT & (SHARD_COUNT - 1)) == 0,
+			"ConcurrentMap SHARD_COUNT must be a power of 2.");
+
+		/* True if lookups are lock-free seqlock reads, see ConcurrentMap */
+		constexpr static bool OPTIMISTIC_READS =
+			std::is_trivially_copyable<KeyType>::value && std::is_trivially_copyable<ValueType>::value;
+
+	private:
+		using EntryType = typename TableType::EntryType;
+
+		struct alignas(64) Shard
+		{
+			mutable SharedSpinLock		lock;
+			std::atomic<uInt32>			version;
+			std::atomic<TableType*>		pTable;
+			Array<TableType*>			retired;
+		};
+
+		/* Makes a shard's version odd for the lifetime of a write, see ConcurrentMap */
+		class WriteGuard
+		{
+		private:
+			Shard& mShard;
+
+		public:
+			WriteGuard(Shard& shard)
+				: mShard(shard)
+			{
+				mShard.lock.Lock();
+
+				if constexpr (OPTIMISTIC_READS)
+				{
+					mShard.version.store(mShard.version.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+					std::atomic_thread_fence(std::memory_order_release);
+				}
+			}
+
+			WriteGuard(const WriteGuard&) = delete;
+			WriteGuard& operator=(const WriteGuard&) = delete;
+
+			~WriteGuard()
+			{
+				if constexpr (OPTIMISTIC_READS)
+				{
+					mShard.version.store(mShard.version.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+				}
+
+				mShard.lock.Unlock();
+			}
+
+			TableType& GetTable()
+			{
+				return *mShard.pTable.load(std::memory_order_relaxed);
+			}
+		};
+
+		Shard	mShards[SHARD_COUNT];
+		hash64	mSeed;
+
+	private:
+		constexpr static uSize ShardBits()
+		{
+			uSize bits = 0;
+			while ((uSize(1) << bits) < SHARD_COUNT)
+			{
+				bits++;
+			}
+
+			return bits;
+		}
+
+		// Shards are selected with the high bits of the hash,
+		// leaving the low bits to index within the shard's Table
+		static uSize ShardIndex(HashType hash)
+		{
+			constexpr uSize shardBits = ShardBits();
+
+			if constexpr (shardBits == 0)
+			{
+				return 0;
+			}
+			else
+			{
+				return static_cast<uSize>(hash >> (sizeof(HashType) * 8 - shardBits));
+			}
+		}
+
+		/*
+			Replaces the table of a locked shard with a copy that holds at
+			least count entries and is at least twice as large. The old
+			table is kept for lookups that may still be probing it.
+		*/
+		static void GrowTable(Shard& shard, uSize count)
+		{
+			TableType* pOldTable = shard.pTable.load(std::memory_order_relaxed);
+
+			const HashType fitted	= TableType::CapacityFor(static_cast<HashType>(count));
+			const HashType doubled	= pOldTable->Capacity() * 2;
+			TableType* pNewTable	= new TableType(fitted > doubled ? fitted : doubled);
+
+			EntryType* pEntries = pOldTable->Data();
+
+			for (uSize i = 0; i < pOldTable->Capacity(); i++)
+			{
+				if (pEntries[i].IsEmpty())
+				{
+					continue;
+				}
+
+				if constexpr (OPTIMISTIC_READS)
+				{
+					// Lookups may still be probing the old table, leave it intact
+					pNewTable->Insert(pEntries[i].hash, pEntries[i].keyValue);
+				}
+				else
+				{
+					pNewTable->Insert(pEntries[i].hash, Move(pEntries[i].keyValue));
+				}
+			}
+
+			shard.pTable.store(pNewTable, std::memory_order_release);
+
+			if constexpr (OPTIMISTIC_READS)
+			{
+				shard.retired.PushBack(pOldTable);
+			}
+			else
+			{
+				delete pOldTable;
+			}
+		}
+
+		/* Grows the table of a locked shard if inserting a new key would rehash it */
+		static TableType& InsertableTable(Shard& shard)
+		{
+			TableType& table = *shard.pTable.load(std::memory_order_relaxed);
+
+			if (table.Size() + 1 < table.Threshold())
+			{
+				return table;
+			}
+
+			GrowTable(shard, table.Size() + 1);
+
+			return *shard.pTable.load(std::memory_order_relaxed);
+		}
+
+		/*
+			Probes a shard without locking it, see ConcurrentMap. Copies the
+			value of key into pOutValue if it is not nullptr.
+		*/
+		template<typename LookupType>
+		static bool FindOptimistic(const Shard& shard, HashType hash, const LookupType& key, ValueType* pOutValue)
+		{
+			SpinWait spin;
+
+			while (true)
+			{
+				const uInt32 version = shard.version.load(std::memory_order_acquire);
+
+				if (version & 1)
+				{
+					spin.Wait();
+					continue;
+				}
+
+				const TableType* pTable		= shard.pTable.load(std::memory_order_acquire);
+				const EntryType* pEntries	= pTable->Data();
+				const uSize capacity		= pTable->Capacity();
+
+				// The entries may be changing under the probe, so it is
+				// bounded by the capacity rather than by an empty entry
+				uSize index	= static_cast<uSize>(hash % capacity);
+				bool found	= false;
+				ValueType value;
+
+				for (uSize dist = 0; dist < capacity; dist++)
+				{
+					const EntryType& entry = pEntries[index];
+
+					if (entry.IsEmpty() || dist > entry.probe)
+					{
+						break;
+					}
+
+					if (entry.hash == hash && entry.keyValue == key)
+					{
+						value = entry.keyValue.value;
+						found = true;
+						break;
+					}
+
+					index = index + 1 < capacity ? index + 1 : 0;
+				}
+
+				std::atomic_thread_fence(std::memory_order_acquire);
+
+				if (shard.version.load(std::memory_order_relaxed) == version)
+				{
+					if (found && pOutValue)
+					{
+						*pOutValue = value;
+					}
+
+					return found;
+				}
+			}
+		}
+
+	public:
+		ConcurrentMap()
+			: ConcurrentMap(DefaultHashSeed()) {}
+
+		/* Hashes keys with a seed, see HashSeeded() and Map::SetSeed() */
+		explicit ConcurrentMap(hash64 seed)
+			: mSeed(seed)
+		{
+			for (Shard& shard : mShards)
+			{
+				shard.version.store(0, std::memory_order_relaxed);
+				shard.pTable.store(new TableType(), std::memory_order_relaxed);
+			}
+		}
+
+		ConcurrentMap(const ConcurrentMap&) = delete;
+		ConcurrentMap& operator=(const ConcurrentMap&) = delete;
+
+		~ConcurrentMap()
+		{
+			for (Shard& shard : mShards)
+			{
+				delete shard.pTable.load(std::memory_order_relaxed);
+
+				for (TableType* pTable : shard.retired)
+				{
+					delete pTable;
+				}
+			}
+		}
+
+		template<typename RKeyType, typename RValueType>
+		void Put(RKeyType&& key, RValueType&& value)
+		{
+			HashType hash = HashSeeded<KeyType>(key, mSeed);
+			Shard& shard = mShards[ShardIndex(hash)];
+
+			WriteGuard guard(shard);
+			InsertableTable(shard).Insert(hash, PairType(Forward<RKeyType>(key), Forward<RValueType>(value)));
+		}
+
+		/*
+			Finds or default-inserts the value of key, then calls
+			updateFunc(ValueType&) on it while the shard is locked.
+		*/
+		template<typename RKeyType, typename UpdateFunc>
+		void Update(RKeyType&& key, UpdateFunc updateFunc)
+		{
+			if constexpr (_IsTransparentLookup<KeyType, RKeyType>())
+			{
+				HashType hash = HashLookupSeeded<KeyType>(key, mSeed);
+				Shard& shard = mShards[ShardIndex(hash)];
+
+				WriteGuard guard(shard);
+				TableType& table = guard.GetTable();
+				typename TableType::Iterator tableIt = table.Find(hash, key);
+
+				if (tableIt != table.End())
+				{
+					updateFunc(tableIt->AsKeyValue().value);
+				}
+				else
+				{
+					// Inserts always store a KeyType, transparent lookups hash identically
+					updateFunc(InsertableTable(shard).Insert(hash, PairType(KeyType(Forward<RKeyType>(key)))).value);
+				}
+			}
+			else
+			{
+				Update(KeyType(Forward<RKeyType>(key)), updateFunc);
+			}
+		}
+
+		/* Copies the value of key into outValue, returns false if not found */
+		template<typename LookupType>
+		bool Find(const LookupType& key, ValueType& outValue) const
+		{
+			const auto& lookup = LookupKey<KeyType>(key);
+			HashType hash = HashLookupSeeded<KeyType>(lookup, mSeed);
+			const Shard& shard = mShards[ShardIndex(hash)];
+
+			if constexpr (OPTIMISTIC_READS)
+			{
+				return FindOptimistic(shard, hash, lookup, &outValue);
+			}
+			else
+			{
+				SharedLockGuard<SharedSpinLock> guard(shard.lock);
+				const TableType& table = *shard.pTable.load(std::memory_order_relaxed);
+				typename TableType::ConstIterator tableIt = table.Find(hash, lookup);
+
+				if (tableIt == table.End())
+				{
+					return false;
+				}
+
+				outValue = tableIt->AsKeyValue().value;
+
+				return true;
+			}
+		}
+
+		template<typename LookupType>
+		bool Contains(const LookupType& key) const
+		{
+			const auto& lookup = LookupKey<KeyType>(key);
+			HashType hash = HashLookupSeeded<KeyType>(lookup, mSeed);
+			const Shard& shard = mShards[ShardIndex(hash)];
+
+			if constexpr (OPTIMISTIC_READS)
+			{
+				return FindOptimistic(shard, hash, lookup, nullptr);
+			}
+			else
+			{
+				SharedLockGuard<SharedSpinLock> guard(shard.lock);
+				return shard.pTable.load(std::memory_order_relaxed)->Contains(hash, lookup);
+			}
+		}
+
+		/* Removes key, returns false if it was not found */
+		template<typename LookupType>
+		bool Remove(const LookupType& key)
+		{
+			const auto& lookup = LookupKey<KeyType>(key);
+			HashType hash = HashLookupSeeded<KeyType>(lookup, mSeed);
+			Shard& shard = mShards[ShardIndex(hash)];
+
+			WriteGuard guard(shard);
+			TableType& table = guard.GetTable();
+			typename TableType::Iterator tableIt = table.Find(hash, lookup);
+
+			if (tableIt == table.End())
+			{
+				return false;
+			}
+
+			table.Remove(tableIt);
+
+			return true;
+		}
+
+		/* Reserves space for count entries, spread evenly across shards */
+		void Reserve(uSize count)
+		{
+			const uSize shardCount = count / SHARD_COUNT + 1;
+
+			for (Shard& shard : mShards)
+			{
+				WriteGuard guard(shard);
+
+				if (TableType::CapacityFor(static_cast<HashType>(shardCount)) > guard.GetTable().Capacity())
+				{
+					GrowTable(shard, shardCount);
+				}
+			}
+		}
+
+		void Clear()
+		{
+			for (Shard& shard : mShards)
+			{
+				WriteGuard guard(shard);
+				guard.GetTable().Clear();
+			}
+		}
+
+		/* Note: The size is only exact if no other thread is writing */
+		uSize Size() const
+		{
+			uSize size = 0;
+
+			for (const Shard& shard : mShards)
+			{
+				SharedLockGuard<SharedSpinLock> guard(shard.lock);
+				size += shard.pTable.load(std::memory_order_relaxed)->Size();
+			}
+
+			return size;
+		}
+
+		bool IsEmpty() const
+		{
+			return Size() == 0;
+		}
+
+		constexpr uSize ShardCount() const
+		{
+			return SHARD_COUNT;
+		}
+
+		hash64 Seed() const
+		{
+			return mSeed;
+		}
+	};
+}
\ No newline at end of file
@@ -0,0 +1,207 @@
+#pragma once
+
+#include "Map.h"
+
+namespace Quartz
+{
+	/*====================================================
+	|                QUARTZLIB COUNT MAP                 |
+	=====================================================*/
+
+	/*
+		A hash-map from keys to integer counts. Increment() hashes and
+		probes once, inserting missing keys at zero, and keys are removed
+		as soon as Decrement() brings their count to zero.
+	*/
+	template<typename KeyType, typename CountType = uSize, typename HashType = uSize, typename PolicyType = TablePolicy>
+	class CountMap
+	{
+	public:
+		using MapType		= Map<KeyType, CountType, HashType, PolicyType>;
+		using PairType		= typename MapType::PairType;
+		using Iterator		= typename MapType::Iterator;
+		using ConstIterator	= typename MapType::ConstIterator;
+
+		constexpr static uSize BATCH_SIZE = MapType::BATCH_SIZE;
+
+	private:
+		MapType mMap;
+
+	private:
+		friend void Swap(CountMap& map1, CountMap& map2)
+		{
+			using Quartz::Swap;
+			Swap(map1.mMap, map2.mMap);
+		}
+
+	public:
+		CountMap()
+			: mMap() {}
+
+		CountMap(const CountMap& map)
+			: mMap(map.mMap) {}
+
+		CountMap(CountMap&& map) noexcept
+			: CountMap()
+		{
+			Swap(*this, map);
+		}
+
+		/* Adds amount to the count of key, returns the new count. See ForwardKey() */
+		template<typename RKeyType>
+		CountType Increment(RKeyType&& key, CountType amount = 1)
+		{
+			return mMap.Get(ForwardKey<KeyType>(Forward<RKeyType>(key))) += amount;
+		}
+
+		/*
+			Increments the count of every key by one. Keys are hashed and
+			their buckets prefetched BATCH_SIZE at a time, as in Map::FindBatch.
+		*/
+		void IncrementBatch(const KeyType* pKeys, uSize count)
+		{
+			hash64 hashes[BATCH_SIZE];
+
+			for (uSize batchStart = 0; batchStart < count; batchStart += BATCH_SIZE)
+			{
+				const uSize batchCount = (count - batchStart) < BATCH_SIZE ?
+					(count - batchStart) : BATCH_SIZE;
+
+				for (uSize i = 0; i < batchCount; i++)
+				{
+					hashes[i] = mMap.HashKey(pKeys[batchStart + i]);
+					mMap.Prefetch(hashes[i]);
+				}
+
+				for (uSize i = 0; i < batchCount; i++)
+				{
+					++mMap.Get(hashes[i], pKeys[batchStart + i]);
+				}
+			}
+		}
+
+		/*
+			Subtracts amount from the count of key, removing the key if the
+			count reaches zero. Returns the new count.
+		*/
+		template<typename LookupType>
+		CountType Decrement(const LookupType& key, CountType amount = 1)
+		{
+			Iterator it = mMap.Find(key);
+
+			if (it == mMap.End())
+			{
+				return 0;
+			}
+
+			if (it->value <= amount)
+			{
+				mMap.Remove(it);
+				return 0;
+			}
+
+			return it->value -= amount;
+		}
+
+		/* Returns the count of key, or 0 if not found */
+		template<typename LookupType>
+		CountType Count(const LookupType& key) const
+		{
+			ConstIterator it = mMap.Find(key);
+			return it == mMap.End() ? 0 : it->value;
+		}
+
+		template<typename LookupType>
+		void Remove(const LookupType& key)
+		{
+			mMap.Remove(key);
+		}
+
+		template<typename LookupType>
+		bool Contains(const LookupType& key) const
+		{
+			return mMap.Contains(key);
+		}
+
+		/* Grows the map so count keys can be held without rehashing */
+		bool Reserve(uSize count)
+		{
+			return mMap.Reserve(count);
+		}
+
+		/* Rehashes the keys with a new seed, see Map::SetSeed() */
+		void SetSeed(hash64 seed)
+		{
+			mMap.SetSeed(seed);
+		}
+
+		void Clear()
+		{
+			mMap.Clear();
+		}
+
+		/* Returns the number of keys with a non-zero count */
+		uSize Size() const
+		{
+			return mMap.Size();
+		}
+
+		bool IsEmpty() const
+		{
+			return mMap.IsEmpty();
+		}
+
+		const MapType& GetMap() const
+		{
+			return mMap;
+		}
+
+		CountMap& operator=(CountMap map)
+		{
+			Swap(*this, map);
+			return *this;
+		}
+
+		Iterator Begin()
+		{
+			return mMap.Begin();
+		}
+
+		ConstIterator Begin() const
+		{
+			return mMap.Begin();
+		}
+
+		Iterator End()
+		{
+			return mMap.End();
+		}
+
+		ConstIterator End() const
+		{
+			return mMap.End();
+		}
+
+		// for-each functions:
+
+		Iterator begin()
+		{
+			return Begin();
+		}
+
+		Iterator end()
+		{
+			return End();
+		}
+
+		ConstIterator begin() const
+		{
+			return Begin();
+		}
+
+		ConstIterator end() const
+		{
+			return End();
+		}
+	};
+}
\ No newline at end of file
@@ -0,0 +1,331 @@
+#pragma once
+
+#include "Types.h"
+#include "Array.h"
+#include "Utility/Hash.h"
+#include "Utility/Swap.h"
+
+namespace Quartz
+{
+	/*====================================================
+	|              QUARTZLIB CUCKOO FILTER               |
+	=====================================================*/
+
+	/*
+		A cuckoo filter of 16-bit fingerprints in buckets of four. Unlike a
+		BloomFilter it supports Remove(), and at the same false positive
+		rate it is smaller once the rate is below about 3%.
+
+		Each key has two candidate buckets, i1 and i1 ^ Hash(fingerprint).
+		A bucket is one uInt64, so both are checked with a few SWAR word
+		operations. When both are full a resident fingerprint is evicted
+		to its alternate bucket, up to MAX_KICKS times. If that fails the
+		last evicted fingerprint is kept aside, so no key is ever lost, and
+		the filter reports itself full.
+
+		Note: Only remove keys that were added, removing any other key can
+		remove the fingerprint of a colliding key.
+	*/
+	class CuckooFilter
+	{
+	public:
+		constexpr static uSize BUCKET_SLOTS		= 4;
+		constexpr static uSize MAX_KICKS		= 500;
+		constexpr static float MAX_LOAD_FACTOR	= 0.95f;
+
+	private:
+		constexpr static uInt64 LANE_ONES	= 0x0001000100010001ull;
+		constexpr static uInt64 LANE_HIGHS	= 0x8000800080008000ull;
+
+		Array<uInt64>	mBuckets;
+		uSize			mBucketMask;
+		uSize			mSize;
+		uInt64			mKickState;
+		uInt16			mVictim;
+		uSize			mVictimIndex;
+
+	private:
+		friend void Swap(CuckooFilter& filter1, CuckooFilter& filter2)
+		{
+			using Quartz::Swap;
+			Swap(filter1.mBuckets, filter2.mBuckets);
+			Swap(filter1.mBucketMask, filter2.mBucketMask);
+			Swap(filter1.mSize, filter2.mSize);
+			Swap(filter1.mKickState, filter2.mKickState);
+			Swap(filter1.mVictim, filter2.mVictim);
+			Swap(filter1.mVictimIndex, filter2.mVictimIndex);
+		}
+
+		static uInt16 FingerprintOf(hash64 hash)
+		{
+			// 0 marks an empty slot
+			const uInt16 fingerprint = static_cast<uInt16>(hash >> 48);
+			return fingerprint != 0 ? fingerprint : 1;
+		}
+
+		uSize AltIndex(uSize index, uInt16 fingerprint) const
+		{
+			return (index ^ static_cast<uSize>(Hash<uInt32>(fingerprint))) & mBucketMask;
+		}
+
+		/* Returns a mask with the high bit set in each 16-bit lane equal to value */
+		static uInt64 MatchLanes(uInt64 bucket, uInt16 value)
+		{
+			const uInt64 diff = bucket ^ (LANE_ONES * value);
+			return (diff - LANE_ONES) & ~diff & LANE_HIGHS;
+		}
+
+		static uSize FirstLane(uInt64 laneMask)
+		{
+			uSize lane = 0;
+
+			while (!(laneMask & (uInt64(0x8000) << (lane * 16))))
+			{
+				lane++;
+			}
+
+			return lane;
+		}
+
+		static uInt16 GetLane(uInt64 bucket, uSize lane)
+		{
+			return static_cast<uInt16>(bucket >> (lane * 16));
+		}
+
+		static uInt64 SetLane(uInt64 bucket, uSize lane, uInt16 value)
+		{
+			const uSize shift = lane * 16;
+			return (bucket & ~(uInt64(0xFFFF) << shift)) | (uInt64(value) << shift);
+		}
+
+		bool TryPlace(uSize index, uInt16 fingerprint)
+		{
+			const uInt64 emptyLanes = MatchLanes(mBuckets[index], 0);
+
+			if (!emptyLanes)
+			{
+				return false;
+			}
+
+			mBuckets[index] = SetLane(mBuckets[index], FirstLane(emptyLanes), fingerprint);
+			return true;
+		}
+
+		bool TryRemove(uSize index, uInt16 fingerprint)
+		{
+			const uInt64 matchLanes = MatchLanes(mBuckets[index], fingerprint);
+
+			if (!matchLanes)
+			{
+				return false;
+			}
+
+			mBuckets[index] = SetLane(mBuckets[index], FirstLane(matchLanes), 0);
+			return true;
+		}
+
+		uInt64 NextKick()
+		{
+			// xorshift64
+			mKickState ^= mKickState << 13;
+			mKickState ^= mKickState >> 7;
+			mKickState ^= mKickState << 17;
+
+			return mKickState;
+		}
+
+	public:
+		CuckooFilter()
+			: mBuckets(), mBucketMask(0), mSize(0), mKickState(0x9E3779B97F4A7C15ull),
+			mVictim(0), mVictimIndex(0) {}
+
+		/* Sizes the filter to hold expectedCount keys */
+		CuckooFilter(uSize expectedCount)
+			: CuckooFilter()
+		{
+			const uSize minBuckets = static_cast<uSize>(expectedCount / (BUCKET_SLOTS * MAX_LOAD_FACTOR)) + 1;
+			uSize bucketCount = 1;
+
+			while (bucketCount < minBuckets)
+			{
+				bucketCount *= 2;
+			}
+
+			mBuckets	= Array<uInt64>(bucketCount, 0);
+			mBucketMask	= bucketCount - 1;
+		}
+
+		CuckooFilter(const CuckooFilter& filter)
+			: mBuckets(filter.mBuckets), mBucketMask(filter.mBucketMask), mSize(filter.mSize),
+			mKickState(filter.mKickState), mVictim(filter.mVictim), mVictimIndex(filter.mVictimIndex) {}
+
+		CuckooFilter(CuckooFilter&& filter) noexcept
+			: CuckooFilter()
+		{
+			Swap(*this, filter);
+		}
+
+		/* Adds a key, returns false if the filter is full */
+		template<typename KeyType>
+		bool Add(const KeyType& key)
+		{
+			return AddHash(HashLookup<KeyType>(key));
+		}
+
+		/* Adds a key by its HashLookup() hash, returns false if the filter is full */
+		bool AddHash(hash64 hash)
+		{
+			if (mBuckets.IsEmpty() || mVictim != 0)
+			{
+				return false;
+			}
+
+			uInt16 fingerprint = FingerprintOf(hash);
+			const uSize index1 = static_cast<uSize>(hash) & mBucketMask;
+			const uSize index2 = AltIndex(index1, fingerprint);
+
+			if (TryPlace(index1, fingerprint) || TryPlace(index2, fingerprint))
+			{
+				mSize++;
+				return true;
+			}
+
+			// Both buckets are full, evict residents to their alternate buckets
+
+			uSize index = (NextKick() & 1) ? index1 : index2;
+
+			for (uSize kick = 0; kick < MAX_KICKS; kick++)
+			{
+				const uSize lane = static_cast<uSize>(NextKick() % BUCKET_SLOTS);
+				const uInt16 evicted = GetLane(mBuckets[index], lane);
+
+				mBuckets[index] = SetLane(mBuckets[index], lane, fingerprint);
+				fingerprint = evicted;
+				index = AltIndex(index, fingerprint);
+
+				if (TryPlace(index, fingerprint))
+				{
+					mSize++;
+					return true;
+				}
+			}
+
+			// Keep the homeless fingerprint so its key still matches
+			mVictim			= fingerprint;
+			mVictimIndex	= index;
+			mSize++;
+
+			return true;
+		}
+
+		template<typename KeyType>
+		bool MayContain(const KeyType& key) const
+		{
+			return MayContainHash(HashLookup<KeyType>(key));
+		}
+
+		bool MayContainHash(hash64 hash) const
+		{
+			if (mBuckets.IsEmpty())
+			{
+				return false;
+			}
+
+			const uInt16 fingerprint = FingerprintOf(hash);
+			const uSize index1 = static_cast<uSize>(hash) & mBucketMask;
+			const uSize index2 = AltIndex(index1, fingerprint);
+
+			if (mVictim == fingerprint && (mVictimIndex == index1 || mVictimIndex == index2))
+			{
+				return true;
+			}
+
+			return (MatchLanes(mBuckets[index1], fingerprint) | MatchLanes(mBuckets[index2], fingerprint)) != 0;
+		}
+
+		/* Removes an added key, returns false if it was not found */
+		template<typename KeyType>
+		bool Remove(const KeyType& key)
+		{
+			return RemoveHash(HashLookup<KeyType>(key));
+		}
+
+		bool RemoveHash(hash64 hash)
+		{
+			if (mBuckets.IsEmpty())
+			{
+				return false;
+			}
+
+			const uInt16 fingerprint = FingerprintOf(hash);
+			const uSize index1 = static_cast<uSize>(hash) & mBucketMask;
+			const uSize index2 = AltIndex(index1, fingerprint);
+
+			if (mVictim == fingerprint && (mVictimIndex == index1 || mVictimIndex == index2))
+			{
+				mVictim = 0;
+				mSize--;
+				return true;
+			}
+
+			if (TryRemove(index1, fingerprint) || TryRemove(index2, fingerprint))
+			{
+				mSize--;
+
+				// Room may have been freed for the victim
+				if (mVictim != 0 && (TryPlace(mVictimIndex, mVictim) ||
+					TryPlace(AltIndex(mVictimIndex, mVictim), mVictim)))
+				{
+					mVictim = 0;
+				}
+
+				return true;
+			}
+
+			return false;
+		}
+
+		void Clear()
+		{
+			for (uSize i = 0; i < mBuckets.Size(); i++)
+			{
+				mBuckets[i] = 0;
+			}
+
+			mSize	= 0;
+			mVictim	= 0;
+		}
+
+		/* Returns true once an Add() has failed to find room */
+		bool IsFull() const
+		{
+			return mVictim != 0;
+		}
+
+		uSize Size() const
+		{
+			return mSize;
+		}
+
+		uSize Capacity() const
+		{
+			return mBuckets.Size() * BUCKET_SLOTS;
+		}
+
+		float LoadFactor() const
+		{
+			return mBuckets.IsEmpty() ? 0.0f : static_cast<float>(mSize) / Capacity();
+		}
+
+		uSize SizeBytes() const
+		{
+			return mBuckets.Size() * sizeof(uInt64);
+		}
+
+		CuckooFilter& operator=(CuckooFilter filter)
+		{
+			Swap(*this, filter);
+			return *this;
+		}
+	};
+}
\ No newline at end of file
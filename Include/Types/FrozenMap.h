@@ -0,0 +1,423 @@
+#pragma once
+
+#include "Map.h"
+
+#include <assert.h>
+
+namespace Quartz
+{
+	/*====================================================
+	|                QUARTZLIB FROZEN MAP                |
+	=====================================================*/
+
+	/*
+		An immutable hash-map using a minimal perfect hash (CHD/hash-and-displace).
+
+		Keys are grouped into buckets of about BUCKET_LOAD keys. Each bucket
+		stores a displacement seed that sends all of its keys to distinct
+		slots of a dense pair array, so a lookup is one bucket read and one
+		slot read with no probing. Storage is exactly one pair per key plus
+		4 bytes per bucket.
+
+		Repeated keys keep the value given last. If the keys cannot be
+		placed, the build is retried with a new hash seed. After
+		MAX_BUILD_ATTEMPTS failed seeds the map is left empty and
+		IsValid() returns false, which asserts in debug builds. This only
+		happens when many distinct keys hash to the same value.
+	*/
+	template<typename KeyType, typename ValueType>
+	class FrozenMap
+	{
+	public:
+		using PairType		= MapPair<KeyType, ValueType>;
+
+		using Iterator		= Quartz::Iterator<FrozenMap, PairType>;
+		using ConstIterator = Quartz::ConstIterator<FrozenMap, PairType>;
+
+		constexpr static uSize BUCKET_LOAD			= 4;
+		constexpr static int32 MAX_DISPLACEMENT		= 1 << 20;
+		constexpr static uSize MAX_BUILD_ATTEMPTS	= 8;
+
+	private:
+		Array<PairType>	mPairs;
+
+		// Per-bucket seed. Negative values are singleton buckets
+		// placed directly in slot (-displacement - 1)
+		Array<int32>	mDisplacements;
+		hash64			mSeed;
+		bool			mValid;
+
+	private:
+		friend void Swap(FrozenMap& map1, FrozenMap& map2)
+		{
+			using Quartz::Swap;
+			Swap(map1.mPairs, map2.mPairs);
+			Swap(map1.mDisplacements, map2.mDisplacements);
+			Swap(map1.mSeed, map2.mSeed);
+			Swap(map1.mValid, map2.mValid);
+		}
+
+		uSize BucketIndex(hash64 hash) const
+		{
+			return static_cast<uSize>(hash % mDisplacements.Size());
+		}
+
+		uSize SlotIndex(hash64 hash, int32 displacement) const
+		{
+			if (displacement < 0)
+			{
+				return static_cast<uSize>(-displacement - 1);
+			}
+
+			hash64 slotHash = Hash<uInt64>(hash + static_cast<uInt64>(displacement) * 0x9E3779B97F4A7C15ull);
+			return static_cast<uSize>(slotHash % mPairs.Size());
+		}
+
+		template<typename LookupType>
+		const PairType* FindPair(const LookupType& key) const
+		{
+			if (mPairs.IsEmpty())
+			{
+				return nullptr;
+			}
+
+			const auto& lookup = LookupKey<KeyType>(key);
+			const hash64 hash = HashLookupSeeded<KeyType>(lookup, mSeed);
+			const PairType& pair = mPairs.Data()[SlotIndex(hash, mDisplacements.Data()[BucketIndex(hash)])];
+
+			return pair.key == lookup ? &pair : nullptr;
+		}
+
+		/*
+			Places the keys with hashes seeded by seed. Returns false if two
+			different keys have equal hashes or a bucket finds no displacement
+			within MAX_DISPLACEMENT, in which case another seed is tried.
+		*/
+		template<typename GetKeyFunc, typename GetValueFunc>
+		bool TryBuild(uSize count, GetKeyFunc& getKey, GetValueFunc& getValue, hash64 seed)
+		{
+			const uSize bucketCount = (count + BUCKET_LOAD - 1) / BUCKET_LOAD;
+
+			mDisplacements	= Array<int32>(bucketCount, 0);
+			mSeed			= seed;
+
+			// Group key indices by bucket (counting sort)
+
+			Array<hash64> hashes(count);
+			Array<uSize> bucketStarts(bucketCount + 1, 0);
+			Array<uSize> bucketKeys(count);
+
+			for (uSize i = 0; i < count; i++)
+			{
+				hashes[i] = HashLookupSeeded<KeyType>(getKey(i), seed);
+				++bucketStarts[BucketIndex(hashes[i]) + 1];
+			}
+
+			for (uSize i = 0; i < bucketCount; i++)
+			{
+				bucketStarts[i + 1] += bucketStarts[i];
+			}
+
+			{
+				Array<uSize> bucketFill(bucketStarts);
+
+				for (uSize i = 0; i < count; i++)
+				{
+					bucketKeys[bucketFill[BucketIndex(hashes[i])]++] = i;
+				}
+			}
+
+			// Drop repeated keys, keeping the last of each at the end of its
+			// bucket. A bucket's kept keys run from bucketFirst to its end
+
+			Array<uSize> bucketFirst(bucketCount);
+			uSize uniqueCount	= 0;
+			uSize maxBucketSize	= 0;
+
+			for (uSize bucket = 0; bucket < bucketCount; bucket++)
+			{
+				uSize* pKeys			= bucketKeys.Data() + bucketStarts[bucket];
+				const uSize bucketSize	= bucketStarts[bucket + 1] - bucketStarts[bucket];
+				uSize keptCount			= 0;
+
+				for (uSize i = bucketSize; i-- > 0;)
+				{
+					bool repeated = false;
+
+					for (uSize j = bucketSize - keptCount; j < bucketSize && !repeated; j++)
+					{
+						if (hashes[pKeys[j]] == hashes[pKeys[i]])
+						{
+							// Different keys with equal hashes can never be separated
+							if (!(getKey(pKeys[j]) == getKey(pKeys[i])))
+							{
+								return false;
+							}
+
+							repeated = true;
+						}
+					}
+
+					if (!repeated)
+					{
+						++keptCount;
+						pKeys[bucketSize - keptCount] = pKeys[i];
+					}
+				}
+
+				bucketFirst[bucket] = bucketStarts[bucket + 1] - keptCount;
+				uniqueCount += keptCount;
+				maxBucketSize = keptCount > maxBucketSize ? keptCount : maxBucketSize;
+			}
+
+			mPairs = Array<PairType>(uniqueCount);
+
+			// Order buckets largest first (counting sort by size), as large
+			// buckets are hardest to place once the slots fill up
+
+			Array<uSize> sizeStarts(maxBucketSize + 2, 0);
+			Array<uSize> bucketOrder(bucketCount);
+
+			for (uSize i = 0; i < bucketCount; i++)
+			{
+				++sizeStarts[maxBucketSize - (bucketStarts[i + 1] - bucketFirst[i]) + 1];
+			}
+
+			for (uSize i = 0; i <= maxBucketSize; i++)
+			{
+				sizeStarts[i + 1] += sizeStarts[i];
+			}
+
+			for (uSize i = 0; i < bucketCount; i++)
+			{
+				bucketOrder[sizeStarts[maxBucketSize - (bucketStarts[i + 1] - bucketFirst[i])]++] = i;
+			}
+
+			// Find a displacement for each bucket that maps its keys to free slots
+
+			Array<bool> slotUsed(uniqueCount, false);
+			Array<uSize> bucketSlots(maxBucketSize > 0 ? maxBucketSize : 1);
+			uSize nextFreeSlot = 0;
+
+			for (uSize orderIdx = 0; orderIdx < bucketCount; orderIdx++)
+			{
+				const uSize bucket		= bucketOrder[orderIdx];
+				const uSize* pKeys		= bucketKeys.Data() + bucketFirst[bucket];
+				const uSize bucketSize	= bucketStarts[bucket + 1] - bucketFirst[bucket];
+
+				if (bucketSize == 0)
+				{
+					break;
+				}
+
+				if (bucketSize == 1)
+				{
+					// Singletons go straight to the remaining free slots
+					while (slotUsed[nextFreeSlot])
+					{
+						++nextFreeSlot;
+					}
+
+					slotUsed[nextFreeSlot] = true;
+					mDisplacements[bucket] = -static_cast<int32>(nextFreeSlot) - 1;
+
+					continue;
+				}
+
+				bool placed = false;
+
+				for (int32 displacement = 0; displacement < MAX_DISPLACEMENT && !placed; displacement++)
+				{
+					placed = true;
+
+					for (uSize i = 0; i < bucketSize && placed; i++)
+					{
+						const uSize slot = SlotIndex(hashes[pKeys[i]], displacement);
+
+						placed = !slotUsed[slot];
+
+						for (uSize j = 0; j < i && placed; j++)
+						{
+							placed = bucketSlots[j] != slot;
+						}
+
+						bucketSlots[i] = slot;
+					}
+
+					if (placed)
+					{
+						for (uSize i = 0; i < bucketSize; i++)
+						{
+							slotUsed[bucketSlots[i]] = true;
+						}
+
+						mDisplacements[bucket] = displacement;
+					}
+				}
+
+				if (!placed)
+				{
+					return false;
+				}
+			}
+
+			// Move pairs into their slots
+
+			for (uSize bucket = 0; bucket < bucketCount; bucket++)
+			{
+				for (uSize i = bucketFirst[bucket]; i < bucketStarts[bucket + 1]; i++)
+				{
+					const uSize key		= bucketKeys[i];
+					const hash64 hash	= hashes[key];
+					PairType& pair		= mPairs[SlotIndex(hash, mDisplacements[bucket])];
+
+					pair.key	= getKey(key);
+					pair.value	= getValue(key);
+				}
+			}
+
+			return true;
+		}
+
+		/* Builds the map, returns false and leaves it empty if no seed could place the keys */
+		template<typename GetKeyFunc, typename GetValueFunc>
+		bool Build(uSize count, GetKeyFunc getKey, GetValueFunc getValue)
+		{
+			if (count == 0)
+			{
+				return true;
+			}
+
+			hash64 seed = 0;
+
+			for (uSize attempt = 0; attempt < MAX_BUILD_ATTEMPTS; attempt++)
+			{
+				if (TryBuild(count, getKey, getValue, seed))
+				{
+					return true;
+				}
+
+				seed = Hash<uInt64>(seed + 0x9E3779B97F4A7C15ull);
+			}
+
+			mPairs			= Array<PairType>();
+			mDisplacements	= Array<int32>();
+			mSeed			= 0;
+
+			return false;
+		}
+
+	public:
+		FrozenMap()
+			: mPairs(), mDisplacements(), mSeed(0), mValid(true) {}
+
+		template<typename HashType, typename PolicyType>
+		FrozenMap(const Map<KeyType, ValueType, HashType, PolicyType>& map)
+			: FrozenMap()
+		{
+			Array<const PairType*> pairs;
+			pairs.Reserve(map.Size() + 1);
+
+			for (const PairType& pair : map)
+			{
+				pairs.PushBack(&pair);
+			}
+
+			mValid = Build(pairs.Size(),
+				[&](uSize i) -> const KeyType& { return pairs[i]->key; },
+				[&](uSize i) -> const ValueType& { return pairs[i]->value; });
+
+			assert(mValid && "FrozenMap could not place the keys, see IsValid().");
+		}
+
+		FrozenMap(const KeyType* pKeys, const ValueType* pValues, uSize count)
+			: FrozenMap()
+		{
+			mValid = Build(count,
+				[&](uSize i) -> const KeyType& { return pKeys[i]; },
+				[&](uSize i) -> const ValueType& { return pValues[i]; });
+
+			assert(mValid && "FrozenMap could not place the keys, see IsValid().");
+		}
+
+		FrozenMap(const FrozenMap& map)
+			: mPairs(map.mPairs), mDisplacements(map.mDisplacements), mSeed(map.mSeed), mValid(map.mValid) {}
+
+		FrozenMap(FrozenMap&& map) noexcept
+			: FrozenMap()
+		{
+			Swap(*this, map);
+		}
+
+		template<typename LookupType>
+		ConstIterator Find(const LookupType& key) const
+		{
+			const PairType* pPair = FindPair(key);
+			return pPair == nullptr ? End() : ConstIterator(pPair);
+		}
+
+		/* Returns a pointer to the value of key, or nullptr if not found */
+		template<typename LookupType>
+		const ValueType* Get(const LookupType& key) const
+		{
+			const PairType* pPair = FindPair(key);
+			return pPair == nullptr ? nullptr : &pPair->value;
+		}
+
+		template<typename LookupType>
+		bool Contains(const LookupType& key) const
+		{
+			return FindPair(key) != nullptr;
+		}
+
+		ConstIterator Begin() const
+		{
+			return ConstIterator(mPairs.Data());
+		}
+
+		ConstIterator End() const
+		{
+			return ConstIterator(mPairs.Data() + mPairs.Size());
+		}
+
+		uSize Size() const
+		{
+			return mPairs.Size();
+		}
+
+		bool IsEmpty() const
+		{
+			return mPairs.IsEmpty();
+		}
+
+		/* Returns false if the keys could not be placed and the map was left empty */
+		bool IsValid() const
+		{
+			return mValid;
+		}
+
+		/* Size in bytes of the pair and displacement storage */
+		uSize SizeBytes() const
+		{
+			return mPairs.Size() * sizeof(PairType) + mDisplacements.Size() * sizeof(int32);
+		}
+
+		FrozenMap& operator=(FrozenMap map)
+		{
+			Swap(*this, map);
+			return *this;
+		}
+
+		// for-each functions:
+
+		ConstIterator begin() const
+		{
+			return Begin();
+		}
+
+		ConstIterator end() const
+		{
+			return End();
+		}
+	};
+}
\ No newline at end of file
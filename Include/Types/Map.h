@@ -60,18 +60,54 @@ namespace Quartz
 		{
 			return key != pair.key;
 		}
+
+		template<typename LookupType>
+		bool operator==(const LookupType& lookupKey) const
+		{
+			return key == lookupKey;
+		}
+
+		template<typename LookupType>
+		bool operator!=(const LookupType& lookupKey) const
+		{
+			return !(key == lookupKey);
+		}
+	};
+
+	/*
+		MapPairs compare equal by key alone, so they hash by key alone. This
+		also lets a MapPair be looked up by its key type.
+	*/
+	template<typename KeyType, typename ValueType>
+	struct Hasher<MapPair<KeyType, ValueType>>
+	{
+		static hash64 HashValue(const MapPair<KeyType, ValueType>& pair)
+		{
+			return Hash<KeyType>(pair.key);
+		}
 	};
 
-	template<typename KeyType, typename ValueType, typename HashType = uSize>
+	template<typename KeyType, typename ValueType>
+	struct SeededHasher<MapPair<KeyType, ValueType>>
+	{
+		static hash64 HashValue(const MapPair<KeyType, ValueType>& pair, hash64 seed)
+		{
+			return HashSeeded<KeyType>(pair.key, seed);
+		}
+	};
+
+	template<typename KeyType, typename ValueType, typename HashType = uSize, typename PolicyType = TablePolicy>
 	class Map
 	{
 	public:
 		using PairType	= MapPair<KeyType, ValueType>;
-		using TableType = Table<PairType, HashType>;
+		using TableType = Table<PairType, HashType, PolicyType>;
 
 		using Iterator		= Quartz::Iterator<Map, PairType>;
 		using ConstIterator = Quartz::ConstIterator<Map, PairType>;
 
+		constexpr static uSize BATCH_SIZE = 16;
+
 	private:
 		TableType mTable;
 
@@ -100,7 +136,7 @@ namespace Quartz
 		template<typename RKeyType, typename RValueType>
 		ValueType& Put(RKeyType&& key, RValueType&& value)
 		{
-			uSize hash = Hash<KeyType>(key);
+			HashType hash = HashSeeded<KeyType>(key, mTable.Seed());
 			return mTable.Insert(hash, PairType(Forward<RKeyType>(key), 
 				Forward<RValueType>(value))).value;
 		}
@@ -108,49 +144,244 @@ namespace Quartz
 		template<typename RKeyType>
 		ValueType& Put(RKeyType&& key)
 		{
-			uSize hash = Hash<KeyType>(key);
+			HashType hash = HashSeeded<KeyType>(key, mTable.Seed());
 			return mTable.Insert(hash, PairType(Forward<RKeyType>(key), ValueType())).value;
 		}
 
+		/* Puts a value using a hash precomputed with HashKey() */
+		template<typename RKeyType, typename RValueType>
+		ValueType& Put(hash64 hash, RKeyType&& key, RValueType&& value)
+		{
+			return mTable.Insert(hash, PairType(Forward<RKeyType>(key),
+				Forward<RValueType>(value))).value;
+		}
+
+		/*
+			Gets the value of key, default-inserting it if not found. Keys of
+			transparent lookup types are only converted to KeyType on insert,
+			see IsTransparentLookup.
+		*/
 		template<typename RKeyType>
 		ValueType& Get(RKeyType&& key)
 		{
-			PairType& pair = mTable.FindInsert(Hash(key), PairType(Forward<RKeyType>(key)));
-			return pair.value;
+			if constexpr (_IsTransparentLookup<KeyType, RKeyType>())
+			{
+				return Get(HashLookupSeeded<KeyType>(key, mTable.Seed()), Forward<RKeyType>(key));
+			}
+			else
+			{
+				KeyType newKey(Forward<RKeyType>(key));
+				const hash64 newHash = HashSeeded<KeyType>(newKey, mTable.Seed());
+				return Get(newHash, Move(newKey));
+			}
 		}
 
-		void Remove(const KeyType& key)
+		/* Gets or default-inserts a value using a hash precomputed with HashKey() */
+		template<typename RKeyType>
+		ValueType& Get(hash64 hash, RKeyType&& key)
 		{
-			mTable.Remove(Hash(key), key);
+			typename TableType::Iterator tableIt = mTable.Find(hash, LookupKey<KeyType>(key));
+
+			if (tableIt != mTable.End())
+			{
+				return tableIt->AsKeyValue().value;
+			}
+
+			// Inserts always store a KeyType hashed as one
+			if constexpr (std::is_same<typename std::decay<RKeyType>::type, KeyType>::value)
+			{
+				return mTable.Insert(hash, PairType(Forward<RKeyType>(key))).value;
+			}
+			else
+			{
+				KeyType newKey(Forward<RKeyType>(key));
+				const hash64 newHash = HashSeeded<KeyType>(newKey, mTable.Seed());
+				return mTable.Insert(newHash, PairType(Move(newKey))).value;
+			}
 		}
 
-		void Remove(Iterator& it)
+		template<typename LookupType>
+		void Remove(const LookupType& key)
 		{
-			mTable.Remove((TableType::EntryType*)it.pItr);
+			const auto& lookup = LookupKey<KeyType>(key);
+			mTable.Remove(HashLookupSeeded<KeyType>(lookup, mTable.Seed()), lookup);
 		}
 
-		template<typename RKeyType>
-		Iterator Find(RKeyType&& key)
+		template<typename LookupType>
+		void Remove(hash64 hash, const LookupType& key)
+		{
+			mTable.Remove(hash, LookupKey<KeyType>(key));
+		}
+
+		/*
+			Removes the pair at it and returns an iterator to the pair after
+			it. Never shrinks the map, see Table::Remove(Iterator).
+		*/
+		Iterator Remove(Iterator it)
 		{
-			typename TableType::Iterator tableIt = 
-				mTable.Find(Hash(key), PairType(Forward<RKeyType>(key)));
+			typename TableType::Iterator tableIt(reinterpret_cast<typename TableType::EntryType*>(it.pItr));
+			tableIt = mTable.Remove(tableIt);
+
+			return tableIt != mTable.End() ? Iterator(&tableIt->AsKeyValue()) : End();
+		}
 
+		/*
+			Finds a value by key. Any type comparable to KeyType that hashes
+			identically (eg. WrapperString or const char* for String keys)
+			can be used without constructing a KeyType.
+		*/
+		template<typename LookupType>
+		Iterator Find(const LookupType& key)
+		{
+			const auto& lookup = LookupKey<KeyType>(key);
+			typename TableType::Iterator tableIt = mTable.Find(HashLookupSeeded<KeyType>(lookup, mTable.Seed()), lookup);
 			return Iterator(&tableIt->AsKeyValue());
 		}
 
-		template<typename RKeyType>
-		ConstIterator Find(RKeyType&& key) const
+		template<typename LookupType>
+		ConstIterator Find(const LookupType& key) const
 		{
-			typename TableType::ConstIterator tableIt = 
-				mTable.Find(Hash(key), PairType(Forward<RKeyType>(key)));
+			const auto& lookup = LookupKey<KeyType>(key);
+			typename TableType::ConstIterator tableIt = mTable.Find(HashLookupSeeded<KeyType>(lookup, mTable.Seed()), lookup);
+			return ConstIterator(&tableIt->AsKeyValue());
+		}
 
+		/* Finds a value using a hash precomputed with HashKey() */
+		template<typename LookupType>
+		Iterator Find(hash64 hash, const LookupType& key)
+		{
+			typename TableType::Iterator tableIt = mTable.Find(hash, LookupKey<KeyType>(key));
+			return Iterator(&tableIt->AsKeyValue());
+		}
+
+		template<typename LookupType>
+		ConstIterator Find(hash64 hash, const LookupType& key) const
+		{
+			typename TableType::ConstIterator tableIt = mTable.Find(hash, LookupKey<KeyType>(key));
 			return ConstIterator(&tableIt->AsKeyValue());
 		}
 
-		template<typename RKeyType>
-		bool Contains(RKeyType&& key)
+		template<typename LookupType>
+		bool Contains(const LookupType& key) const
 		{
-			return mTable.Contains(Hash(key), PairType(Forward<RKeyType>(key)));
+			const auto& lookup = LookupKey<KeyType>(key);
+			return mTable.Contains(HashLookupSeeded<KeyType>(lookup, mTable.Seed()), lookup);
+		}
+
+		template<typename LookupType>
+		bool Contains(hash64 hash, const LookupType& key) const
+		{
+			return mTable.Contains(hash, LookupKey<KeyType>(key));
+		}
+
+		/*
+			Finds a batch of keys, writing a pointer to each value (or nullptr
+			if not found) to ppOutValues. Keys are hashed and their buckets
+			prefetched BATCH_SIZE at a time before being resolved, overlapping
+			the cache misses of large maps. Returns the number of keys found.
+		*/
+		template<typename LookupType>
+		uSize FindBatch(const LookupType* pKeys, uSize count, ValueType** ppOutValues)
+		{
+			HashType hashes[BATCH_SIZE];
+			uSize foundCount = 0;
+
+			for (uSize batchStart = 0; batchStart < count; batchStart += BATCH_SIZE)
+			{
+				const uSize batchCount = (count - batchStart) < BATCH_SIZE ? 
+					(count - batchStart) : BATCH_SIZE;
+
+				for (uSize i = 0; i < batchCount; i++)
+				{
+					hashes[i] = HashLookupSeeded<KeyType>(pKeys[batchStart + i], mTable.Seed());
+					mTable.Prefetch(hashes[i]);
+				}
+
+				for (uSize i = 0; i < batchCount; i++)
+				{
+					typename TableType::Iterator tableIt = 
+						mTable.Find(hashes[i], LookupKey<KeyType>(pKeys[batchStart + i]));
+
+					if (tableIt != mTable.End())
+					{
+						ppOutValues[batchStart + i] = &tableIt->AsKeyValue().value;
+						++foundCount;
+					}
+					else
+					{
+						ppOutValues[batchStart + i] = nullptr;
+					}
+				}
+			}
+
+			return foundCount;
+		}
+
+		template<typename LookupType>
+		uSize FindBatch(const LookupType* pKeys, uSize count, const ValueType** ppOutValues) const
+		{
+			return const_cast<Map*>(this)->FindBatch(pKeys, count, const_cast<ValueType**>(ppOutValues));
+		}
+
+		/*
+			Puts a batch of key/value pairs, replacing existing values.
+			Capacity for all pairs is reserved up front so no rehash occurs
+			between prefetching a bucket and inserting into it.
+		*/
+		void InsertBatch(const KeyType* pKeys, const ValueType* pValues, uSize count)
+		{
+			mTable.Reserve(mTable.Size() + count);
+
+			HashType hashes[BATCH_SIZE];
+
+			for (uSize batchStart = 0; batchStart < count; batchStart += BATCH_SIZE)
+			{
+				const uSize batchCount = (count - batchStart) < BATCH_SIZE ?
+					(count - batchStart) : BATCH_SIZE;
+
+				for (uSize i = 0; i < batchCount; i++)
+				{
+					hashes[i] = HashSeeded<KeyType>(pKeys[batchStart + i], mTable.Seed());
+					mTable.Prefetch(hashes[i]);
+				}
+
+				for (uSize i = 0; i < batchCount; i++)
+				{
+					mTable.Insert(hashes[i], PairType(pKeys[batchStart + i], pValues[batchStart + i]));
+				}
+			}
+		}
+
+		/*
+			Computes the hash used by the precomputed-hash overloads. The
+			hash depends on the map's seed, so it is only valid for this map.
+		*/
+		template<typename LookupType>
+		hash64 HashKey(const LookupType& key) const
+		{
+			return static_cast<HashType>(HashLookupSeeded<KeyType>(key, mTable.Seed()));
+		}
+
+		/* Returns the hash seed of the map, 0 if unseeded */
+		hash64 Seed() const
+		{
+			return mTable.Seed();
+		}
+
+		/*
+			Rehashes the map with a new seed, see HashSeeded(). Seed maps keyed
+			by untrusted input with RandomHashSeed() or ProcessHashSeed() to
+			guard against hash flooding.
+		*/
+		void SetSeed(hash64 seed)
+		{
+			mTable.SetSeed(seed);
+		}
+
+		/* Prefetches the bucket of a hash computed with HashKey() */
+		void Prefetch(hash64 hash) const
+		{
+			mTable.Prefetch(hash);
 		}
 
 		Iterator Begin()
@@ -177,11 +408,11 @@ namespace Quartz
 				return End();
 			}
 
-			Iterator it(&mTable.Data()->AsKeyValue());
+			ConstIterator it(&mTable.Data()->AsKeyValue());
 
 			if (mTable.Data()->IsEmpty())
 			{
-				return ++it;
+				++it;
 			}
 
 			return it;
@@ -197,9 +428,10 @@ namespace Quartz
 			return ConstIterator(&(mTable.Data() + Capacity())->AsKeyValue());
 		}
 
-		bool Reserve(uSize size)
+		/* Grows the map so count entries can be held without rehashing */
+		bool Reserve(uSize count)
 		{
-			return mTable.Reserve(size);
+			return mTable.Reserve(count);
 		}
 
 		void Shrink()
@@ -232,6 +464,17 @@ namespace Quartz
 			return mTable.IsEmpty();
 		}
 
+		const TableType& GetTable() const
+		{
+			return mTable;
+		}
+
+		/* Returns the load and probe statistics of the underlying table */
+		TableStats GetStats() const
+		{
+			return mTable.GetStats();
+		}
+
 		Map& operator=(Map map)
 		{
 			Swap(*this, map);
@@ -270,19 +513,22 @@ namespace Quartz
 
 		friend Iterator& operator++(Iterator& itr)
 		{
-			typename TableType::Iterator& tableItr =
-				reinterpret_cast<typename TableType::Iterator&>(itr);
+			// The key/value is the first member of its entry
+			typename TableType::EntryType* pEntry =
+				reinterpret_cast<typename TableType::EntryType*>(itr.pItr);
 
 			do
 			{
-				if (tableItr.pItr->IsLast())
+				if (pEntry->IsLast())
 				{
-					++tableItr.pItr;
-					return itr;
+					++pEntry;
+					break;
 				}
 
-				++tableItr.pItr;
-			} while (tableItr.pItr->IsEmpty());
+				++pEntry;
+			} while (pEntry->IsEmpty());
+
+			itr.pItr = &pEntry->AsKeyValue();
 
 			return itr;
 		}
@@ -0,0 +1,349 @@
+#pragma once
+
+#include "Map.h"
+#include "Array.h"
+
+namespace Quartz
+{
+	/*====================================================
+	|                QUARTZLIB MULTI MAP                 |
+	=====================================================*/
+
+	/* The slice of a MultiMap's value storage owned by one key */
+	struct MultiMapRange
+	{
+		uSize offset;
+		uSize count;
+		uSize capacity;
+
+		MultiMapRange()
+			: offset(0), count(0), capacity(0) {}
+	};
+
+	/* A non-owning view of the contiguous values of one MultiMap key */
+	template<typename ValueType>
+	class MultiMapValues
+	{
+	public:
+		using Iterator = Quartz::Iterator<MultiMapValues, ValueType>;
+
+	private:
+		ValueType*	mpValues;
+		uSize		mCount;
+
+	public:
+		MultiMapValues()
+			: mpValues(nullptr), mCount(0) {}
+
+		MultiMapValues(ValueType* pValues, uSize count)
+			: mpValues(pValues), mCount(count) {}
+
+		ValueType* Data() const
+		{
+			return mpValues;
+		}
+
+		uSize Size() const
+		{
+			return mCount;
+		}
+
+		bool IsEmpty() const
+		{
+			return mCount == 0;
+		}
+
+		ValueType& operator[](uSize index) const
+		{
+			return mpValues[index];
+		}
+
+		Iterator Begin() const
+		{
+			return Iterator(mpValues);
+		}
+
+		Iterator End() const
+		{
+			return Iterator(mpValues + mCount);
+		}
+
+		// for-each functions:
+
+		Iterator begin() const
+		{
+			return Begin();
+		}
+
+		Iterator end() const
+		{
+			return End();
+		}
+	};
+
+	/*
+		A hash-map holding any number of values per key.
+
+		The values of every key live in one shared Array, each key owning a
+		contiguous range of it that doubles in place or relocates to the end
+		when full. This avoids the per-key allocation of Map<K, Array<V>>,
+		and Find() returns the values as a single contiguous view. Ranges
+		abandoned by relocation or Remove() are reclaimed by compacting the
+		storage once they outweigh the live values.
+
+		Note: Views returned by Find() are invalidated by any Put() or Remove().
+	*/
+	template<typename KeyType, typename ValueType, typename HashType = uSize, typename PolicyType = TablePolicy>
+	class MultiMap
+	{
+	public:
+		using RangeMapType	= Map<KeyType, MultiMapRange, HashType, PolicyType>;
+		using Values		= MultiMapValues<ValueType>;
+		using ConstValues	= MultiMapValues<const ValueType>;
+
+	private:
+		RangeMapType		mRanges;
+		Array<ValueType>	mValues;
+		uSize				mSize;
+		uSize				mGarbage;
+
+	private:
+		friend void Swap(MultiMap& map1, MultiMap& map2)
+		{
+			using Quartz::Swap;
+			Swap(map1.mRanges, map2.mRanges);
+			Swap(map1.mValues, map2.mValues);
+			Swap(map1.mSize, map2.mSize);
+			Swap(map1.mGarbage, map2.mGarbage);
+		}
+
+		void GrowRange(MultiMapRange& range)
+		{
+			const uSize newCapacity = range.capacity > 0 ? range.capacity * 2 : 1;
+
+			if (range.offset + range.capacity == mValues.Size())
+			{
+				// The range is at the end of the storage, grow in place
+				for (uSize i = range.capacity; i < newCapacity; i++)
+				{
+					mValues.PushBack(ValueType());
+				}
+			}
+			else
+			{
+				const uSize newOffset = mValues.Size();
+
+				for (uSize i = 0; i < newCapacity; i++)
+				{
+					mValues.PushBack(ValueType());
+				}
+
+				for (uSize i = 0; i < range.count; i++)
+				{
+					mValues[newOffset + i] = Move(mValues[range.offset + i]);
+				}
+
+				mGarbage += range.capacity;
+				range.offset = newOffset;
+			}
+
+			range.capacity = newCapacity;
+		}
+
+	public:
+		MultiMap()
+			: mRanges(), mValues(), mSize(0), mGarbage(0) {}
+
+		MultiMap(const MultiMap& map)
+			: mRanges(map.mRanges), mValues(map.mValues), mSize(map.mSize), mGarbage(map.mGarbage) {}
+
+		MultiMap(MultiMap&& map) noexcept
+			: MultiMap()
+		{
+			Swap(*this, map);
+		}
+
+		/* Adds a value to key, after any values already held by key */
+		template<typename RKeyType, typename RValueType>
+		ValueType& Put(RKeyType&& key, RValueType&& value)
+		{
+			MultiMapRange& range = mRanges.Get(ForwardKey<KeyType>(Forward<RKeyType>(key)));
+
+			if (range.count == range.capacity)
+			{
+				if (range.capacity > 0 && mGarbage > mValues.Size() / 2)
+				{
+					Compact();
+				}
+
+				GrowRange(range);
+			}
+
+			ValueType& slot = mValues[range.offset + range.count];
+			slot = Forward<RValueType>(value);
+
+			++range.count;
+			++mSize;
+
+			return slot;
+		}
+
+		/* Removes key and all of its values */
+		template<typename LookupType>
+		void Remove(const LookupType& key)
+		{
+			typename RangeMapType::Iterator it = mRanges.Find(key);
+
+			if (it == mRanges.End())
+			{
+				return;
+			}
+
+			MultiMapRange& range = it->value;
+
+			for (uSize i = 0; i < range.count; i++)
+			{
+				mValues[range.offset + i] = ValueType();
+			}
+
+			mSize		-= range.count;
+			mGarbage	+= range.capacity;
+
+			mRanges.Remove(it);
+		}
+
+		/* Returns the values of key, or an empty view if not found */
+		template<typename LookupType>
+		Values Find(const LookupType& key)
+		{
+			typename RangeMapType::Iterator it = mRanges.Find(key);
+
+			if (it == mRanges.End())
+			{
+				return Values();
+			}
+
+			return Values(mValues.Data() + it->value.offset, it->value.count);
+		}
+
+		template<typename LookupType>
+		ConstValues Find(const LookupType& key) const
+		{
+			typename RangeMapType::ConstIterator it = mRanges.Find(key);
+
+			if (it == mRanges.End())
+			{
+				return ConstValues();
+			}
+
+			return ConstValues(mValues.Data() + it->value.offset, it->value.count);
+		}
+
+		/* Returns the number of values held by key */
+		template<typename LookupType>
+		uSize Count(const LookupType& key) const
+		{
+			typename RangeMapType::ConstIterator it = mRanges.Find(key);
+			return it == mRanges.End() ? 0 : it->value.count;
+		}
+
+		template<typename LookupType>
+		bool Contains(const LookupType& key) const
+		{
+			return mRanges.Contains(key);
+		}
+
+		/* Calls func(const KeyType&, Values) for every key */
+		template<typename Func>
+		void ForEach(Func func)
+		{
+			for (MapPair<KeyType, MultiMapRange>& pair : mRanges)
+			{
+				func(static_cast<const KeyType&>(pair.key),
+					Values(mValues.Data() + pair.value.offset, pair.value.count));
+			}
+		}
+
+		template<typename Func>
+		void ForEach(Func func) const
+		{
+			for (const MapPair<KeyType, MultiMapRange>& pair : mRanges)
+			{
+				func(pair.key, ConstValues(mValues.Data() + pair.value.offset, pair.value.count));
+			}
+		}
+
+		/*
+			Repacks all values tightly in key order, releasing the ranges
+			left behind by relocation and Remove().
+		*/
+		void Compact()
+		{
+			Array<ValueType> values;
+
+			if (mSize > 0)
+			{
+				values.Reserve(mSize);
+			}
+
+			for (MapPair<KeyType, MultiMapRange>& pair : mRanges)
+			{
+				MultiMapRange& range = pair.value;
+				const uSize newOffset = values.Size();
+
+				for (uSize i = 0; i < range.count; i++)
+				{
+					values.PushBack(Move(mValues[range.offset + i]));
+				}
+
+				range.offset	= newOffset;
+				range.capacity	= range.count;
+			}
+
+			mValues		= Move(values);
+			mGarbage	= 0;
+		}
+
+		/* Grows the map so keyCount keys can be held without rehashing */
+		bool Reserve(uSize keyCount)
+		{
+			return mRanges.Reserve(keyCount);
+		}
+
+		/* Rehashes the keys with a new seed, see Map::SetSeed() */
+		void SetSeed(hash64 seed)
+		{
+			mRanges.SetSeed(seed);
+		}
+
+		void Clear()
+		{
+			mRanges.Clear();
+			mValues = Array<ValueType>();
+			mSize		= 0;
+			mGarbage	= 0;
+		}
+
+		/* Returns the total number of values */
+		uSize Size() const
+		{
+			return mSize;
+		}
+
+		uSize KeyCount() const
+		{
+			return mRanges.Size();
+		}
+
+		bool IsEmpty() const
+		{
+			return mSize == 0;
+		}
+
+		MultiMap& operator=(MultiMap map)
+		{
+			Swap(*this, map);
+			return *this;
+		}
+	};
+}
\ No newline at end of file
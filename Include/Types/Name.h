@@ -0,0 +1,500 @@
+#pragma once
+
+#include "String.h"
+#include "Table.h"
+#include "Utility/Hash.h"
+#include "Utility/SpinLock.h"
+
+#include <assert.h>
+#include <atomic>
+#include <new>
+
+namespace Quartz
+{
+	/*====================================================
+	|                   QUARTZLIB NAME                   |
+	=====================================================*/
+
+	/*
+		An interned string stored once in a NamePool. The characters follow
+		the entry in the same allocation and never change or move, so the
+		entry is shared by every Name of the same text for the lifetime of
+		the pool.
+	*/
+	template<typename CharType>
+	struct NameEntry
+	{
+		hash64	hash;
+		uInt32	id;
+		uInt32	length;
+
+		const CharType* Str() const
+		{
+			return reinterpret_cast<const CharType*>(this + 1);
+		}
+	};
+
+	/* The entry of the empty name, id 0, shared by all pools */
+	template<typename CharType>
+	const NameEntry<CharType>* _EmptyNameEntry()
+	{
+		static const struct
+		{
+			NameEntry<CharType>	entry;
+			CharType			terminator;
+		}
+		empty = { { QUARTZ_HASH_INVALID, 0, 0 }, CharType(0) };
+
+		return &empty.entry;
+	}
+
+	/*
+		The entry given to names that could not be interned because their
+		pool was full. Its id, NAME_INVALID_ID, is never given to a real
+		entry, so a failed name does not compare equal to the empty name.
+	*/
+	constexpr uInt32 NAME_INVALID_ID = ~uInt32(0);
+
+	template<typename CharType>
+	const NameEntry<CharType>* _InvalidNameEntry()
+	{
+		static const struct
+		{
+			NameEntry<CharType>	entry;
+			CharType			terminator;
+		}
+		invalid = { { QUARTZ_HASH_INVALID, NAME_INVALID_ID, 0 }, CharType(0) };
+
+		return &invalid.entry;
+	}
+
+	/* The key of a NamePool shard Table, compares by text against lookups */
+	template<typename CharType>
+	struct _NameKey
+	{
+		const NameEntry<CharType>* pEntry;
+
+		_NameKey()
+			: pEntry(nullptr) {}
+
+		_NameKey(const NameEntry<CharType>* pEntry)
+			: pEntry(pEntry) {}
+
+		bool operator==(const _NameKey& key) const
+		{
+			return pEntry == key.pEntry;
+		}
+
+		bool operator==(const WrapperStringBase<CharType>& str) const
+		{
+			return pEntry->length == str.Length() &&
+				memcmp(pEntry->Str(), str.Str(), str.Length() * sizeof(CharType)) == 0;
+		}
+	};
+
+	template<typename CharType>
+	class NameBase;
+
+	/*
+		A thread-safe intern pool of NameEntries. Entries are found through
+		SHARD_COUNT Tables, each guarded by a reader/writer spin lock as in
+		ConcurrentMap, so interning a name that already exists only takes a
+		shared lock. Every entry is given a 32-bit id in insertion order,
+		which can be turned back into its Name with FromId() without locking.
+
+		Entries are only freed when the pool is destroyed. The Global() pool
+		is never destroyed.
+	*/
+	template<typename CharType>
+	class NamePoolBase
+	{
+	public:
+		using EntryType			= NameEntry<CharType>;
+		using NameType			= NameBase<CharType>;
+		using WrapperStringType	= WrapperStringBase<CharType>;
+
+		constexpr static uSize	SHARD_COUNT		= 64;
+		constexpr static uSize	SHARD_BITS		= 6;
+		constexpr static uSize	CHUNK_BITS		= 12;
+		constexpr static uSize	CHUNK_SIZE		= uSize(1) << CHUNK_BITS;
+		constexpr static uSize	CHUNK_COUNT		= 4096;
+
+		/* The largest number of names a pool can hold, including the empty name */
+		constexpr static uSize	MAX_NAMES		= CHUNK_SIZE * CHUNK_COUNT;
+
+		static_assert((uSize(1) << SHARD_BITS) == SHARD_COUNT, "NamePool SHARD_BITS must match SHARD_COUNT.");
+
+	private:
+		using KeyType	= _NameKey<CharType>;
+		using TableType	= Table<KeyType, uSize>;
+		using ChunkType	= std::atomic<const EntryType*>;
+
+		struct alignas(64) Shard
+		{
+			mutable SharedSpinLock	lock;
+			TableType				table;
+		};
+
+		Shard					mShards[SHARD_COUNT];
+		std::atomic<ChunkType*>	mChunks[CHUNK_COUNT];
+		std::atomic<uInt32>		mNextId;
+		hash64					mSeed;
+
+	private:
+		static uSize ShardIndex(uSize hash)
+		{
+			return static_cast<uSize>(hash >> (sizeof(uSize) * 8 - SHARD_BITS));
+		}
+
+		hash64 HashOf(const WrapperStringType& str) const
+		{
+			const hash64 hash = HashBytes(str.Str(), str.Length() * sizeof(CharType), mSeed);
+
+			// Keep QUARTZ_HASH_INVALID free, it is the hash of the empty name
+			return hash != QUARTZ_HASH_INVALID ? hash : 1;
+		}
+
+		ChunkType* GetChunk(uSize chunkIndex)
+		{
+			ChunkType* pChunk = mChunks[chunkIndex].load(std::memory_order_acquire);
+
+			if (!pChunk)
+			{
+				ChunkType* pNewChunk = new ChunkType[CHUNK_SIZE];
+
+				for (uSize i = 0; i < CHUNK_SIZE; i++)
+				{
+					pNewChunk[i].store(nullptr, std::memory_order_relaxed);
+				}
+
+				// Another shard may have allocated the chunk first
+				if (mChunks[chunkIndex].compare_exchange_strong(pChunk, pNewChunk, std::memory_order_acq_rel))
+				{
+					pChunk = pNewChunk;
+				}
+				else
+				{
+					delete[] pNewChunk;
+				}
+			}
+
+			return pChunk;
+		}
+
+		/* Creates an entry with the next id, or returns nullptr if the pool is full */
+		const EntryType* CreateEntry(const WrapperStringType& str, hash64 hash)
+		{
+			uInt32 id = mNextId.load(std::memory_order_relaxed);
+
+			// Only take an id below MAX_NAMES, so a full pool stays full
+			do
+			{
+				if (id >= MAX_NAMES)
+				{
+					return nullptr;
+				}
+			}
+			while (!mNextId.compare_exchange_weak(id, id + 1, std::memory_order_relaxed));
+
+			uInt8* pData = new uInt8[sizeof(EntryType) + (str.Length() + 1) * sizeof(CharType)];
+
+			EntryType* pEntry = new (pData) EntryType{ hash, id, static_cast<uInt32>(str.Length()) };
+
+			CharType* pStr = reinterpret_cast<CharType*>(pEntry + 1);
+			memcpy(pStr, str.Str(), str.Length() * sizeof(CharType));
+			pStr[str.Length()] = CharType(0);
+
+			GetChunk(id >> CHUNK_BITS)[id & (CHUNK_SIZE - 1)].store(pEntry, std::memory_order_release);
+
+			return pEntry;
+		}
+
+	public:
+		NamePoolBase()
+			: mNextId(1), mSeed(RandomHashSeed())
+		{
+			for (std::atomic<ChunkType*>& chunk : mChunks)
+			{
+				chunk.store(nullptr, std::memory_order_relaxed);
+			}
+		}
+
+		NamePoolBase(const NamePoolBase&) = delete;
+		NamePoolBase& operator=(const NamePoolBase&) = delete;
+
+		~NamePoolBase()
+		{
+			const uSize count = mNextId.load(std::memory_order_relaxed);
+
+			for (uSize id = 1; id < count && id < MAX_NAMES; id++)
+			{
+				const EntryType* pEntry = mChunks[id >> CHUNK_BITS].load(std::memory_order_relaxed)[id & (CHUNK_SIZE - 1)];
+				delete[] reinterpret_cast<const uInt8*>(pEntry);
+			}
+
+			for (std::atomic<ChunkType*>& chunk : mChunks)
+			{
+				delete[] chunk.load(std::memory_order_relaxed);
+			}
+		}
+
+		/* The pool used by Names constructed from strings */
+		static NamePoolBase& Global()
+		{
+			// Leaked on purpose, so static Names stay valid during static destruction
+			static NamePoolBase* pPool = new NamePoolBase();
+			return *pPool;
+		}
+
+		/*
+			Sets outEntry to the entry of str, adding it if it is not in the
+			pool. Returns false and sets outEntry to the invalid entry if str
+			is new and the pool already holds MAX_NAMES names.
+		*/
+		bool TryIntern(const WrapperStringType& str, const EntryType*& outEntry)
+		{
+			if (str.IsEmpty())
+			{
+				outEntry = _EmptyNameEntry<CharType>();
+				return true;
+			}
+
+			const hash64 hash = HashOf(str);
+			Shard& shard = mShards[ShardIndex(hash)];
+
+			{
+				SharedLockGuard<SharedSpinLock> guard(shard.lock);
+				const TableType& table = shard.table;
+				typename TableType::ConstIterator it = table.Find(hash, str);
+
+				if (it != table.End())
+				{
+					outEntry = it->AsKeyValue().pEntry;
+					return true;
+				}
+			}
+
+			LockGuard<SharedSpinLock> guard(shard.lock);
+
+			// The name may have been added while the lock was released
+			typename TableType::Iterator it = shard.table.Find(hash, str);
+
+			if (it != shard.table.End())
+			{
+				outEntry = it->AsKeyValue().pEntry;
+				return true;
+			}
+
+			const EntryType* pEntry = CreateEntry(str, hash);
+
+			if (!pEntry)
+			{
+				outEntry = _InvalidNameEntry<CharType>();
+				return false;
+			}
+
+			shard.table.Insert(hash, KeyType(pEntry));
+			outEntry = pEntry;
+
+			return true;
+		}
+
+		/*
+			Returns the entry of str, adding it if it is not in the pool.
+			Asserts if the pool is full, and returns the invalid entry in
+			release builds. Use TryIntern where a full pool is expected.
+		*/
+		const EntryType* Intern(const WrapperStringType& str)
+		{
+			const EntryType* pEntry = nullptr;
+			const bool interned = TryIntern(str, pEntry);
+
+			assert(interned && "NamePool is full.");
+			(void)interned;
+
+			return pEntry;
+		}
+
+		/* Returns the entry of str, or nullptr if it was never interned */
+		const EntryType* Find(const WrapperStringType& str) const
+		{
+			if (str.IsEmpty())
+			{
+				return _EmptyNameEntry<CharType>();
+			}
+
+			const hash64 hash = HashOf(str);
+			const Shard& shard = mShards[ShardIndex(hash)];
+
+			SharedLockGuard<SharedSpinLock> guard(shard.lock);
+			typename TableType::ConstIterator it = shard.table.Find(hash, str);
+
+			return it != shard.table.End() ? it->AsKeyValue().pEntry : nullptr;
+		}
+
+		/* Returns the entry with an id, or nullptr if no such entry exists */
+		const EntryType* FromId(uInt32 id) const
+		{
+			if (id == 0)
+			{
+				return _EmptyNameEntry<CharType>();
+			}
+
+			if (id >= MAX_NAMES)
+			{
+				return nullptr;
+			}
+
+			const ChunkType* pChunk = mChunks[id >> CHUNK_BITS].load(std::memory_order_acquire);
+
+			return pChunk ? pChunk[id & (CHUNK_SIZE - 1)].load(std::memory_order_acquire) : nullptr;
+		}
+
+		/* Returns the number of interned names, excluding the empty name */
+		uSize Size() const
+		{
+			return mNextId.load(std::memory_order_relaxed) - 1;
+		}
+	};
+
+	/*
+		An immutable interned string. Names of the same text share one
+		NamePool entry, so comparing two Names is a pointer compare and
+		their hash is computed once, when the text is first interned.
+
+		Interning takes a lock and hashes the text, so construct Names once
+		(for asset, component or event names) and keep them, rather than
+		converting strings to Names on every use. Names from different
+		pools never compare equal.
+	*/
+	template<typename CharType>
+	class NameBase
+	{
+	public:
+		using EntryType			= NameEntry<CharType>;
+		using PoolType			= NamePoolBase<CharType>;
+		using StringType		= StringBase<CharType>;
+		using WrapperStringType	= WrapperStringBase<CharType>;
+
+	private:
+		const EntryType* mpEntry;
+
+	private:
+		explicit NameBase(const EntryType* pEntry)
+			: mpEntry(pEntry) {}
+
+	public:
+		NameBase()
+			: mpEntry(_EmptyNameEntry<CharType>()) {}
+
+		NameBase(const CharType* pStr)
+			: mpEntry(PoolType::Global().Intern(WrapperStringType(pStr))) {}
+
+		NameBase(const CharType* pStr, uSize length)
+			: mpEntry(PoolType::Global().Intern(WrapperStringType(pStr, length))) {}
+
+		NameBase(const WrapperStringType& str)
+			: mpEntry(PoolType::Global().Intern(str)) {}
+
+		NameBase(const StringType& str)
+			: mpEntry(PoolType::Global().Intern(WrapperStringType(str.Str(), str.Length()))) {}
+
+		NameBase(const WrapperStringType& str, PoolType& pool)
+			: mpEntry(pool.Intern(str)) {}
+
+		/*
+			Returns the Name of str if it has already been interned, or
+			the empty Name otherwise. Does not add str to the pool.
+		*/
+		static NameBase Find(const WrapperStringType& str, const PoolType& pool = PoolType::Global())
+		{
+			const EntryType* pEntry = pool.Find(str);
+			return NameBase(pEntry ? pEntry : _EmptyNameEntry<CharType>());
+		}
+
+		/* Returns the Name with an id, or the empty Name if no such name exists */
+		static NameBase FromId(uInt32 id, const PoolType& pool = PoolType::Global())
+		{
+			const EntryType* pEntry = pool.FromId(id);
+			return NameBase(pEntry ? pEntry : _EmptyNameEntry<CharType>());
+		}
+
+		/*
+			Returns false if the name could not be interned because its
+			pool was full. Invalid names have no text and NAME_INVALID_ID.
+		*/
+		bool IsValid() const
+		{
+			return mpEntry != _InvalidNameEntry<CharType>();
+		}
+
+		/* Returns the id of the name in its pool, 0 for the empty name */
+		uInt32 Id() const
+		{
+			return mpEntry->id;
+		}
+
+		const CharType* Str() const
+		{
+			return mpEntry->Str();
+		}
+
+		uSize Length() const
+		{
+			return mpEntry->length;
+		}
+
+		bool IsEmpty() const
+		{
+			return mpEntry->length == 0;
+		}
+
+		hash64 GetHash() const
+		{
+			return mpEntry->hash;
+		}
+
+		WrapperStringType ToWrapper() const
+		{
+			return WrapperStringType(Str(), Length());
+		}
+
+		StringType ToString() const
+		{
+			return StringType(Str(), Length());
+		}
+
+		bool operator==(const NameBase& name) const
+		{
+			return mpEntry == name.mpEntry;
+		}
+
+		bool operator!=(const NameBase& name) const
+		{
+			return mpEntry != name.mpEntry;
+		}
+
+		/* Orders names by id (interning order), not alphabetically */
+		bool operator<(const NameBase& name) const
+		{
+			return mpEntry->id < name.mpEntry->id;
+		}
+	};
+
+	using NamePoolA	= NamePoolBase<char>;
+	using NamePoolW	= NamePoolBase<wchar_t>;
+	using NameA		= NameBase<char>;
+	using NameW		= NameBase<wchar_t>;
+
+	using NamePool	= NamePoolA;
+	using Name		= NameA;
+
+	template<typename CharType>
+	struct Hasher<NameBase<CharType>>
+	{
+		static hash64 HashValue(const NameBase<CharType>& value)
+		{
+			return value.GetHash();
+		}
+	};
+}
\ No newline at end of file
@@ -9,17 +9,17 @@ namespace Quartz
 	|                   QUARTZLIB SET                    |
 	=====================================================*/
 
-	template<typename ValueType, typename HashType = uSize>
+	template<typename ValueType, typename HashType = uSize, typename PolicyType = TablePolicy>
 	class Set
 	{
 	public:
-		using TableType	= Table<ValueType, HashType>;
+		using TableType	= Table<ValueType, HashType, PolicyType>;
 
 		using Iterator		= Quartz::Iterator<Set, ValueType>;
 		using ConstIterator = Quartz::ConstIterator<Set, ValueType>;
 
 	private:
-		Table<ValueType> mTable;
+		TableType mTable;
 
 	private:
 		friend void Swap(Set& set1, Set& set2)
@@ -28,6 +28,26 @@ namespace Quartz
 			Swap(set1.mTable, set2.mTable);
 		}
 
+		/* Calls func(hash, value) for every value, reusing the stored hashes */
+		template<typename Func>
+		void ForEachHashed(Func func) const
+		{
+			const typename TableType::EntryType* pEntries = mTable.Data();
+
+			for (uSize i = 0; i < mTable.Capacity(); i++)
+			{
+				if (!pEntries[i].IsEmpty())
+				{
+					func(pEntries[i].hash, pEntries[i].AsKeyValue());
+				}
+			}
+		}
+
+		HashType HashOf(const ValueType& value) const
+		{
+			return static_cast<HashType>(HashSeeded<ValueType>(value, mTable.Seed()));
+		}
+
 	public:
 		Set()
 			: mTable() {}
@@ -46,18 +66,168 @@ namespace Quartz
 		template<typename RValueType>
 		ValueType& Add(RValueType&& value)
 		{
-			return mTable.Insert(Hash(value), Forward<RValueType>(value));
+			return mTable.Insert(HashSeeded<ValueType>(value, mTable.Seed()), Forward<RValueType>(value));
 		}
 
+		/* Adds a value using a hash precomputed with HashKey() */
 		template<typename RValueType>
-		void Remove(RValueType&& value)
+		ValueType& Add(hash64 hash, RValueType&& value)
+		{
+			return mTable.Insert(hash, Forward<RValueType>(value));
+		}
+
+		template<typename LookupType>
+		void Remove(const LookupType& value)
+		{
+			const auto& lookup = LookupKey<ValueType>(value);
+			mTable.Remove(HashLookupSeeded<ValueType>(lookup, mTable.Seed()), lookup);
+		}
+
+		template<typename LookupType>
+		bool Contains(const LookupType& value) const
+		{
+			const auto& lookup = LookupKey<ValueType>(value);
+			return mTable.Contains(HashLookupSeeded<ValueType>(lookup, mTable.Seed()), lookup);
+		}
+
+		template<typename LookupType>
+		void Remove(hash64 hash, const LookupType& value)
+		{
+			mTable.Remove(hash, LookupKey<ValueType>(value));
+		}
+
+		template<typename LookupType>
+		bool Contains(hash64 hash, const LookupType& value) const
+		{
+			return mTable.Contains(hash, LookupKey<ValueType>(value));
+		}
+
+		/*
+			Set algebra. Stored hashes are reused, so no value is rehashed
+			unless the sets have different seeds, and where the operation
+			allows the smaller set is probed into the larger one. Results
+			take the seed of the set their hashes come from.
+		*/
+
+		/* Returns the values in this set or in set */
+		Set Union(const Set& set) const
+		{
+			const Set& larger	= Size() >= set.Size() ? *this : set;
+			const Set& smaller	= Size() >= set.Size() ? set : *this;
+
+			const bool sameSeed = larger.Seed() == smaller.Seed();
+
+			Set result(larger);
+			result.Reserve(larger.Size() + smaller.Size());
+
+			smaller.ForEachHashed([&](HashType hash, const ValueType& value)
+			{
+				result.mTable.FindInsert(sameSeed ? hash : larger.HashOf(value), value);
+			});
+
+			return result;
+		}
+
+		/* Returns the values in both this set and set */
+		Set Intersect(const Set& set) const
+		{
+			const Set& larger	= Size() >= set.Size() ? *this : set;
+			const Set& smaller	= Size() >= set.Size() ? set : *this;
+
+			const bool sameSeed = larger.Seed() == smaller.Seed();
+
+			Set result;
+			result.SetSeed(smaller.Seed());
+			result.Reserve(smaller.Size());
+
+			smaller.ForEachHashed([&](HashType hash, const ValueType& value)
+			{
+				if (larger.mTable.Contains(sameSeed ? hash : larger.HashOf(value), value))
+				{
+					result.mTable.Insert(hash, value);
+				}
+			});
+
+			return result;
+		}
+
+		/* Returns the values in this set that are not in set */
+		Set Difference(const Set& set) const
+		{
+			const bool sameSeed = Seed() == set.Seed();
+
+			Set result;
+			result.SetSeed(Seed());
+			result.Reserve(Size());
+
+			ForEachHashed([&](HashType hash, const ValueType& value)
+			{
+				if (!set.mTable.Contains(sameSeed ? hash : set.HashOf(value), value))
+				{
+					result.mTable.Insert(hash, value);
+				}
+			});
+
+			return result;
+		}
+
+		/* Returns true if every value of this set is in set */
+		bool IsSubset(const Set& set) const
+		{
+			if (Size() > set.Size())
+			{
+				return false;
+			}
+
+			const bool sameSeed = Seed() == set.Seed();
+
+			const typename TableType::EntryType* pEntries = mTable.Data();
+
+			for (uSize i = 0; i < mTable.Capacity(); i++)
+			{
+				if (pEntries[i].IsEmpty())
+				{
+					continue;
+				}
+
+				const ValueType& value	= pEntries[i].AsKeyValue();
+				const HashType hash		= sameSeed ? pEntries[i].hash : set.HashOf(value);
+
+				if (!set.mTable.Contains(hash, value))
+				{
+					return false;
+				}
+			}
+
+			return true;
+		}
+
+		/*
+			Computes the hash used by the precomputed-hash overloads. The
+			hash depends on the set's seed, so it is only valid for this set.
+		*/
+		template<typename LookupType>
+		hash64 HashKey(const LookupType& value) const
+		{
+			return static_cast<HashType>(HashLookupSeeded<ValueType>(value, mTable.Seed()));
+		}
+
+		/* Returns the hash seed of the set, 0 if unseeded */
+		hash64 Seed() const
 		{
-			mTable.Remove(Hash(value), Forward<RValueType>(value));
+			return mTable.Seed();
 		}
 
-		bool Contains(const ValueType& value)
+		/* Rehashes the set with a new seed, see Map::SetSeed() */
+		void SetSeed(hash64 seed)
 		{
-			return mTable.Contains(Hash(value), value);
+			mTable.SetSeed(seed);
+		}
+
+		/* Prefetches the bucket of a hash computed with HashKey() */
+		void Prefetch(hash64 hash) const
+		{
+			mTable.Prefetch(hash);
 		}
 
 		Iterator Begin()
@@ -119,9 +289,10 @@ namespace Quartz
 			mTable.Clear();
 		}
 
-		bool Reserve(uSize size)
+		/* Grows the set so count values can be held without rehashing */
+		bool Reserve(uSize count)
 		{
-			return mTable.Reserve(size);
+			return mTable.Reserve(count);
 		}
 
 		void Shrink()
@@ -149,6 +320,17 @@ namespace Quartz
 			return mTable.IsEmpty();
 		}
 
+		const TableType& GetTable() const
+		{
+			return mTable;
+		}
+
+		/* Returns the load and probe statistics of the underlying table */
+		TableStats GetStats() const
+		{
+			return mTable.GetStats();
+		}
+
 		Set& operator=(Set set)
 		{
 			Swap(*this, set);
@@ -181,19 +363,22 @@ namespace Quartz
 
 		friend Iterator& operator++(Iterator& itr)
 		{
-			typename TableType::Iterator& tableItr =
-				reinterpret_cast<typename TableType::Iterator&>(itr);
+			// The key/value is the first member of its entry
+			typename TableType::EntryType* pEntry =
+				reinterpret_cast<typename TableType::EntryType*>(itr.pItr);
 
 			do
 			{
-				if (tableItr.pItr->IsLast())
+				if (pEntry->IsLast())
 				{
-					++tableItr.pItr;
-					return itr;
+					++pEntry;
+					break;
 				}
 
-				++tableItr.pItr;
-			} while (tableItr.pItr->IsEmpty());
+				++pEntry;
+			} while (pEntry->IsEmpty());
+
+			itr.pItr = &pEntry->AsKeyValue();
 
 			return itr;
 		}
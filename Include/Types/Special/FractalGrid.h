@@ -148,9 +148,9 @@ namespace Quartz
 	};
 
 	template<>
-	inline uSize Hash<FractalPoint>(const FractalPoint& value)
+	inline hash64 Hash<FractalPoint>(const FractalPoint& value)
 	{
-		return Hash<uSize>(value.h * 35791113 ^ value.x * 24681012 ^ value.y * 346791013);
+		return HashCombine(HashCombine(Hash<uSize>(value.h), Hash<uSize>(value.x)), Hash<uSize>(value.y));
 	}
 
 	inline bool operator==(const FractalPoint& point0, const FractalPoint& point1)
@@ -2,15 +2,23 @@
 
 #include "Types.h"
 #include "Utility/Hash.h"
+#include "Utility/StringSearch.h"
 #include "Memory/Memory.h"
 #include "Utility/Swap.h"
 #include "Utility/Whitespace.h"
 
 #include <cstring>
 #include <assert.h>
+#include <atomic>
+#include <new>
 
 #define DEBUG_STRING_LENGTH_CHECK 0
 
+// Set to 0 to refcount all strings non-atomically, for single-threaded programs
+#ifndef QUARTZ_STRING_THREAD_SAFE
+#define QUARTZ_STRING_THREAD_SAFE 1
+#endif
+
 namespace Quartz
 {
 	/*====================================================
@@ -41,6 +49,12 @@ namespace Quartz
 	template<typename CharType>
 	class SubstringBase;
 
+	template<typename CharType>
+	class StringBuilderBase;
+
+	template<typename CharType>
+	class SplitRangeBase;
+
 	template<typename _CharType>
 	class StringBase
 	{
@@ -49,58 +63,149 @@ namespace Quartz
 		using SubstringType		= SubstringBase<CharType>;
 		using WrapperStringType = WrapperStringBase<CharType>;
 
-		using SubstringBase		= SubstringBase<CharType>;
-		using WrapperStringBase = WrapperStringBase<CharType>;
+		// Builds heap buffers in place and hands them over, see StringBuilderBase::ToString()
+		friend class StringBuilderBase<CharType>;
+
+		// Locates the characters of small sources, see SubstringBase::SetStart()
+		friend class Quartz::SubstringBase<CharType>;
 
 	protected:
 
+		/*
+			The header of a heap string buffer. Copies on different threads
+			may share a buffer, so the refcount is atomic: increments are
+			relaxed, and decrements release so that the last owner acquires
+			every other owner's writes before freeing. Buffers flagged
+			threadLocal are refcounted with plain loads and stores instead.
+		*/
 		struct StringMeta
 		{
-			uSize	refCount;
-			uSize	length;
-			hash64	hash;
+			std::atomic<uSize>	refCount;
+			uSize				length;
+			std::atomic<hash64>	hash;
+			bool				threadLocal;
 
 			StringMeta() :
-				refCount(1), length(0), hash(QUARTZ_HASH_INVALID) { }
+				refCount(1), length(0), hash(QUARTZ_HASH_INVALID), threadLocal(!QUARTZ_STRING_THREAD_SAFE) { }
 
 			StringMeta(uSize refCount, uSize length, hash64 hash) :
-				refCount(refCount), length(length), hash(hash) { }
+				refCount(refCount), length(length), hash(hash), threadLocal(!QUARTZ_STRING_THREAD_SAFE) { }
 		};
 
+		/*
+			Short strings are stored inline (small mode) without allocating.
+			The last byte of the object holds the small length, or HEAP_TAG
+			when the characters live in a shared, refcounted heap buffer of
+			[StringMeta][characters] (heap mode).
+		*/
+
+		static constexpr uSize	metaSize		= sizeof(StringMeta);
+		static constexpr uSize	SMALL_BYTES		= 3 * sizeof(void*);
+		static constexpr uInt8	HEAP_TAG		= 0xFF;
+
+	public:
+		/* The longest string stored without allocating */
+		static constexpr uSize	SMALL_CAPACITY	= (SMALL_BYTES - 1) / sizeof(CharType) - 1;
+
+	protected:
 		union
 		{
 			uInt8*		mpData;
 			StringMeta* mpMeta;
+			uInt8		mSmall[SMALL_BYTES];
 		};
 
-		static constexpr uSize metaSize = sizeof(StringMeta);
+		static_assert(SMALL_CAPACITY < HEAP_TAG && SMALL_BYTES > sizeof(uInt8*),
+			"String small buffer must leave room for the small length.");
 
 	private:
 		friend void Swap(StringBase& str1, StringBase& str2)
 		{
-			using Quartz::Swap;
-			Swap(str1.mpData, str2.mpData);
+			uInt8 temp[SMALL_BYTES];
+			memcpy(temp, str1.mSmall, SMALL_BYTES);
+			memcpy(str1.mSmall, str2.mSmall, SMALL_BYTES);
+			memcpy(str2.mSmall, temp, SMALL_BYTES);
+		}
+
+		bool IsSmall() const
+		{
+			return mSmall[SMALL_BYTES - 1] != HEAP_TAG;
+		}
+
+		/* Sets up storage for length characters, the string must not own any storage */
+		void Allocate(uSize length)
+		{
+			if (length <= SMALL_CAPACITY)
+			{
+				mSmall[SMALL_BYTES - 1] = static_cast<uInt8>(length);
+				reinterpret_cast<CharType*>(mSmall)[length] = '\0';
+			}
+			else
+			{
+				mpData = new uInt8[metaSize + (length + 1) * sizeof(CharType)];
+				new (mpData) StringMeta(1, length, QUARTZ_HASH_INVALID);
+				mSmall[SMALL_BYTES - 1] = HEAP_TAG;
+
+				reinterpret_cast<CharType*>(mpData + metaSize)[length] = '\0';
+			}
+		}
+
+		void AddRef()
+		{
+			if (mpMeta->threadLocal)
+			{
+				mpMeta->refCount.store(mpMeta->refCount.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+			}
+			else
+			{
+				mpMeta->refCount.fetch_add(1, std::memory_order_relaxed);
+			}
+		}
+
+		void Release()
+		{
+			if (IsSmall())
+			{
+				return;
+			}
+
+			if (mpMeta->threadLocal)
+			{
+				const uSize refCount = mpMeta->refCount.load(std::memory_order_relaxed) - 1;
+				mpMeta->refCount.store(refCount, std::memory_order_relaxed);
+
+				if (refCount == 0)
+				{
+					delete[] mpData;
+				}
+			}
+			else if (mpMeta->refCount.fetch_sub(1, std::memory_order_release) == 1)
+			{
+				std::atomic_thread_fence(std::memory_order_acquire);
+				delete[] mpData;
+			}
 		}
 
 	public:
-		StringBase() : 
-			mpData(new uInt8[metaSize + sizeof(CharType)])
+		StringBase()
 		{
-			*mpMeta = StringMeta(1, 0, QUARTZ_HASH_INVALID);
-			*reinterpret_cast<CharType*>(mpData + metaSize) = '\0';
+			Allocate(0);
 		}
 
 		StringBase(const uSize length)
-			: mpData(new uInt8[metaSize + (length + 1 * sizeof(CharType))])
 		{
-			*mpMeta = StringMeta(1, length, QUARTZ_HASH_INVALID);
-			*reinterpret_cast<CharType*>(mpData + metaSize + (length * sizeof(CharType))) = '\0';
+			Allocate(length);
+			memset(Data(), 0, length * sizeof(CharType));
 		}
 
 		StringBase(const StringBase& str)
-			: mpData(str.mpData)
 		{
-			++mpMeta->refCount;
+			memcpy(mSmall, str.mSmall, SMALL_BYTES);
+
+			if (!IsSmall())
+			{
+				AddRef();
+			}
 		}
 
 		StringBase(StringBase&& str) noexcept
@@ -117,56 +222,43 @@ namespace Quartz
 #if DEBUG_STRING_LENGTH_CHECK
 			assert(!(length > 0 && length > StrLen(pStr)));
 #endif
-			const uSize strBufferSize	= (length + 1) * sizeof(CharType);
-			const uSize fullBufferSize	= metaSize + strBufferSize;
-
-			mpData = new uInt8[fullBufferSize]{};
-
-			*mpMeta = StringMeta(1, length, QUARTZ_HASH_INVALID);
-			MemCopy((void*)(mpData + metaSize), (void*)pStr, strBufferSize);
-
-			// Set last value to zero (null-termination)
-			reinterpret_cast<CharType*>(mpData + metaSize)[length] = '\0';
+			Allocate(length);
+			MemCopy((void*)Data(), (void*)pStr, length * sizeof(CharType));
 		}
 
-		StringBase(const WrapperStringBase& str)
+		StringBase(const WrapperStringType& str)
 			: StringBase(str.Str(), str.Length()) { }
 
-		StringBase(const SubstringBase& substr)
+		StringBase(const SubstringType& substr)
 			: StringBase(substr.Str(), substr.Length()) { }
 
 		~StringBase()
 		{
-			if (mpMeta && --mpMeta->refCount == 0)
-			{
-				delete[] mpData;
-			}
+			Release();
 		}
 
-		StringBase Append(const WrapperStringBase& str) const
+		StringBase Append(const WrapperStringType& str) const
 		{
-			StringBase result;
-			result.Resize(mpMeta->length + str.Length());
-			MemCopy((void*)(result.mpData + metaSize), (void*)(mpData + metaSize), mpMeta->length);
-			MemCopy((void*)(result.mpData + metaSize + mpMeta->length), (void*)str.Str(), str.Length() * sizeof(CharType));
+			StringBase result(Length() + str.Length());
+			MemCopy((void*)result.Data(), (void*)Str(), Length() * sizeof(CharType));
+			MemCopy((void*)(result.Data() + Length()), (void*)str.Str(), str.Length() * sizeof(CharType));
 			return result;
 		}
 
 		StringBase Append(const StringBase& str) const
 		{
-			StringBase result;
-			result.Resize(mpMeta->length + str.mpMeta->length);
-			MemCopy((void*)(result.mpData + metaSize), (void*)(mpData + metaSize), mpMeta->length);
-			MemCopy((void*)(result.mpData + metaSize + mpMeta->length), (void*)str.Str(), str.mpMeta->length * sizeof(CharType));
+			StringBase result(Length() + str.Length());
+			MemCopy((void*)result.Data(), (void*)Str(), Length() * sizeof(CharType));
+			MemCopy((void*)(result.Data() + Length()), (void*)str.Str(), str.Length() * sizeof(CharType));
 			return result;
 		}
 
-		SubstringBase TrimWhitespace() const
+		SubstringType TrimWhitespace() const
 		{
 			return TrimWhitespaceForward().TrimWhitespaceReverse();
 		}
 
-		SubstringBase TrimWhitespaceForward() const
+		SubstringType TrimWhitespaceForward() const
 		{
 			if (IsEmpty())
 			{
@@ -174,7 +266,7 @@ namespace Quartz
 			}
 
 			uSize idx = 0;
-			while (idx < mLength && IsWhitespace(Str()[idx]))
+			while (idx < Length() && IsWhitespace(Str()[idx]))
 			{
 				idx++;
 			}
@@ -182,14 +274,14 @@ namespace Quartz
 			return Substring(idx);
 		}
 
-		SubstringBase TrimWhitespaceReverse() const
+		SubstringType TrimWhitespaceReverse() const
 		{
 			if (IsEmpty())
 			{
 				return *this;
 			}
 
-			uSize idx = mLength - 1;
+			uSize idx = Length() - 1;
 			while (idx > 0 && IsWhitespace(Str()[idx]))
 			{
 				idx--;
@@ -198,86 +290,45 @@ namespace Quartz
 			return Substring(0, idx + 1);
 		}
 
+		/* Returns the index of the first occurrence of pStr, or Length() if not found */
 		uSize Find(const CharType* pStr) const
 		{
-			const CharType* foundStr = StrStrMax(Str(), pStr, Length());
-
-			if (!foundStr)
-			{
-				return Length();
-			}
-			else
-			{
-				return (uSize)(foundStr - Str()) / sizeof(CharType);
-			}
+			const CharType* pFound = StrFind(Str(), Length(), pStr, StrLen(pStr));
+			return pFound ? static_cast<uSize>(pFound - Str()) : Length();
 		}
 
 		uSize Find(const StringBase& str) const
 		{
-			const CharType* foundStr = StrStrMax(Str(), str.Str(), Length());
-
-			if (!foundStr)
-			{
-				return Length();
-			}
-			else
-			{
-				return (uSize)(foundStr - Str()) / sizeof(CharType);
-			}
+			const CharType* pFound = StrFind(Str(), Length(), str.Str(), str.Length());
+			return pFound ? static_cast<uSize>(pFound - Str()) : Length();
 		}
 
+		/* Returns the index of the last occurrence of pStr, or Length() if not found */
 		uSize FindReverse(const CharType* pStr) const
 		{
-			const CharType* pStart = Str();
-			const CharType* pSubStr = pStart + (Length() - 1);
-			uSize revLength = 1;
-
-			while (pSubStr != pStart)
-			{
-				WrapperStringBase testStr(pSubStr, revLength);
-
-				if (testStr.StartsWith(WrapperStringBase(pStr)))
-				{
-					return Length() - revLength;
-				}
-
-				pSubStr--;
-				revLength++;
-			}
-
-			return 0;
+			const CharType* pFound = StrFindReverse(Str(), Length(), pStr, StrLen(pStr));
+			return pFound ? static_cast<uSize>(pFound - Str()) : Length();
 		}
 
 		uSize FindReverse(const StringBase& str) const
 		{
-			const CharType* pStart = Str();
-			const CharType* pSubStr = pStart + (Length() - 1);
-			uSize revLength = 1;
-
-			while (pSubStr != pStart)
-			{
-				WrapperStringBase testStr(pSubStr, revLength);
-
-				if (testStr.StartsWith(str))
-				{
-					return Length() - revLength;
-				}
-
-				pSubStr--;
-				revLength++;
-			}
-
-			return 0;
+			const CharType* pFound = StrFindReverse(Str(), Length(), str.Str(), str.Length());
+			return pFound ? static_cast<uSize>(pFound - Str()) : Length();
 		}
 
 		bool StartsWith(const CharType* pStr) const
 		{
 			const CharType* pStr1 = Str();
-			const CharType* pStr2 = pStr;
+			const uSize length = StrLen(pStr);
 
-			for (uSize i = 0; i < str.Length(); i++)
+			if (length > Length())
 			{
-				if (pStr1[i] != pStr2[i] || pStr[i] == '\0')
+				return false;
+			}
+
+			for (uSize i = 0; i < length; i++)
+			{
+				if (pStr1[i] != pStr[i])
 				{
 					return false;
 				}
@@ -307,37 +358,83 @@ namespace Quartz
 			return true;
 		}
 
-		SubstringBase Substring(uSize start, uSize end) const
+		SubstringType Substring(uSize start, uSize end) const
 		{
-			return SubstringBase(*this, start, end);
+			return SubstringType(*this, start, end);
 		}
 
-		SubstringBase Substring(uSize start) const
+		SubstringType Substring(uSize start) const
+		{
+			return SubstringType(*this, start, Length());
+		}
+
+		/* Returns the fields between any of the characters in delims, see SplitRangeBase */
+		SplitRangeBase<CharType> Split(const WrapperStringType& delims) const
+		{
+			return SplitRangeBase<CharType>(Substring(0), delims, SplitRangeBase<CharType>::SPLIT_FIELDS);
+		}
+
+		/* Returns the lines, without their \n or \r\n terminators */
+		SplitRangeBase<CharType> Lines() const
+		{
+			return Substring(0).Lines();
+		}
+
+		/* Returns the runs of characters between whitespace */
+		SplitRangeBase<CharType> Tokens() const
 		{
-			return SubstringBase(*this, start, Length());
+			return Substring(0).Tokens();
+		}
+
+		/* Returns the runs of characters between any of the characters in delims */
+		SplitRangeBase<CharType> Tokens(const WrapperStringType& delims) const
+		{
+			return SplitRangeBase<CharType>(Substring(0), delims, SplitRangeBase<CharType>::SPLIT_TOKENS);
 		}
 
 		bool operator==(const StringBase& str) const
 		{
-			return (Length() == str.Length()) &&
-				(StrCmpCount(Str(), str.Str(), Length()) == 0);
+			if (Length() != str.Length())
+			{
+				return false;
+			}
+
+			if (!IsSmall() && !str.IsSmall())
+			{
+				// Copies share a buffer, and strings with different cached hashes differ
+				if (mpData == str.mpData)
+				{
+					return true;
+				}
+
+				const hash64 hash1 = mpMeta->hash.load(std::memory_order_relaxed);
+				const hash64 hash2 = str.mpMeta->hash.load(std::memory_order_relaxed);
+
+				if (hash1 != hash2 && hash1 != QUARTZ_HASH_INVALID && hash2 != QUARTZ_HASH_INVALID)
+				{
+					return false;
+				}
+			}
+
+			return _StrEqualCount(Str(), str.Str(), Length());
 		}
 
-		bool operator==(const WrapperStringBase& str) const
+		bool operator==(const WrapperStringType& str) const
 		{
 			return (Length() == str.Length()) &&
-				(StrCmpCount(Str(), str.Str(), Length()) == 0);
+				_StrEqualCount(Str(), str.Str(), Length());
 		}
 
-		bool operator==(const SubstringBase& substr) const
+		bool operator==(const SubstringType& substr) const
 		{
 			return (Length() == substr.Length()) &&
-				(StrCmpCount(Str(), substr.Str(), Length()) == 0);
+				_StrEqualCount(Str(), substr.Str(), Length());
 		}
 
 		bool operator==(const CharType* pStr) const
 		{
-			return StrCmpCount(Str(), pStr, Length()) == 0;
+			return (StrCmpCount(Str(), pStr, Length()) == 0) && 
+				(pStr[Length()] == '\0');
 		}
 
 		bool operator!=(const StringBase& str) const
@@ -345,12 +442,12 @@ namespace Quartz
 			return !operator==(str);
 		}
 
-		bool operator!=(const WrapperStringBase& str) const
+		bool operator!=(const WrapperStringType& str) const
 		{
 			return !operator==(str);
 		}
 
-		bool operator!=(const SubstringBase& substr) const
+		bool operator!=(const SubstringType& substr) const
 		{
 			return !operator==(substr);
 		}
@@ -368,10 +465,10 @@ namespace Quartz
 
 		StringBase operator+(const CharType* pStr) const
 		{
-			return this->Append(WrapperStringBase(pStr));
+			return this->Append(WrapperStringType(pStr));
 		}
 
-		StringBase operator+(const WrapperStringBase& str) const
+		StringBase operator+(const WrapperStringType& str) const
 		{
 			return this->Append(str);
 		}
@@ -381,14 +478,14 @@ namespace Quartz
 			return this->Append(str);
 		}
 
-		friend StringBase operator+(const WrapperStringBase& str1, const StringBase& str2)
+		friend StringBase operator+(const WrapperStringType& str1, const StringBase& str2)
 		{
 			return String(str1).Append(str2);
 		}
 
 		StringBase& operator+=(const CharType* pStr)
 		{
-			*this = this->Append(pStr);
+			*this = this->Append(WrapperStringType(pStr));
 			return *this;
 		}
 
@@ -398,80 +495,105 @@ namespace Quartz
 			return *this;
 		}
 
+		/*
+			Resizes the string into its own unshared storage, keeping the
+			first length characters. Added characters are zeroed.
+		*/
 		StringBase& Resize(uSize length)
 		{
-			const uSize strBufferSize = (length + 1) * sizeof(CharType);
-			const uSize fullBufferSize = metaSize + strBufferSize;
+			StringBase resized(length);
 
-			const uInt8* mpPrev = mpData;
+			const uSize keepLength = length < Length() ? length : Length();
+			MemCopy((void*)resized.Data(), (void*)Str(), keepLength * sizeof(CharType));
 
-			mpData = new uInt8[fullBufferSize]{};
-			mpMeta->refCount = ((StringMeta*)mpPrev)->refCount;
-			mpMeta->length = length;
-
-			reinterpret_cast<CharType*>(mpData + metaSize)[length] = '\0';
-
-			delete mpPrev;
+			Swap(*this, resized);
 
 			return *this;
 		}
 
 		const CharType* Str() const
 		{
-			return reinterpret_cast<const CharType*>(mpData + metaSize);
+			return IsSmall() ? reinterpret_cast<const CharType*>(mSmall) :
+				reinterpret_cast<const CharType*>(mpData + metaSize);
 		}
 
+		/*
+			Returns the characters for writing. Copies share a buffer, so
+			writes show in all of them. The cached hash is reset, so write
+			the characters before the next GetHash() or comparison.
+		*/
 		CharType* Data()
 		{
+			if (IsSmall())
+			{
+				return reinterpret_cast<CharType*>(mSmall);
+			}
+
+			mpMeta->hash.store(QUARTZ_HASH_INVALID, std::memory_order_relaxed);
+
 			return reinterpret_cast<CharType*>(mpData + metaSize);
 		}
 
 		uSize Length() const
 		{
-			return mpMeta->length;
+			return IsSmall() ? mSmall[SMALL_BYTES - 1] : mpMeta->length;
 		}
 
+		/* Returns the number of strings sharing the buffer, 1 for small strings */
 		uSize RefCount() const
 		{
-			return mpMeta->refCount;
+			return IsSmall() ? 1 : mpMeta->refCount.load(std::memory_order_relaxed);
+		}
+
+		/*
+			Flags the string's buffer as owned by the calling thread only, so
+			it is refcounted without atomic operations. The flag is shared by
+			all later copies, which must then stay on the same thread. Only
+			call this on a unique string. Small strings are never refcounted.
+		*/
+		void SetThreadLocal(bool threadLocal)
+		{
+			assert(IsUnique());
+
+			if (!IsSmall())
+			{
+				mpMeta->threadLocal = threadLocal;
+			}
+		}
+
+		bool IsThreadLocal() const
+		{
+			return IsSmall() || mpMeta->threadLocal;
 		}
 
 		bool IsUnique() const
 		{
-			return mpMeta->refCount == 1;
+			return RefCount() == 1;
 		}
 
 		bool IsEmpty() const
 		{
-			return mpMeta->length == 0;
+			return Length() == 0;
 		}
 
 		hash64 GetHash()
 		{
-			if (mpMeta->hash != QUARTZ_HASH_INVALID)
+			// Only heap strings cache their hash, small strings are cheap to rehash
+			if (!IsSmall() && mpMeta->hash.load(std::memory_order_relaxed) != QUARTZ_HASH_INVALID)
 			{
-				return mpMeta->hash;
+				return mpMeta->hash.load(std::memory_order_relaxed);
 			}
 			else
 			{
-				// MurmurOAAT64 Hash
-
-				const CharType* pStr = Str();
-				const CharType* pStrEnd = Str() + Length();
-
-				uInt64 hash = 525201411107845655ull;
+				const hash64 hash = HashBytes(Str(), Length() * sizeof(CharType));
 
-				while (pStr != pStrEnd && *pStr)
+				if (!IsSmall())
 				{
-					hash ^= *pStr;
-					hash *= 0x5bd1e9955bd1e995;
-					hash ^= hash >> 47;
-					pStr++;
+					// Racing threads compute the same value, so a relaxed store is enough
+					mpMeta->hash.store(hash, std::memory_order_relaxed);
 				}
 
-				mpMeta->hash = static_cast<hash64>(hash);
-
-				return mpMeta->hash;
+				return hash;
 			}
 		}
 
@@ -495,11 +617,16 @@ namespace Quartz
 		const CharType*	mpStr;
 		hash64			mHash;
 
+		// When nonzero, the characters are at this byte offset from the
+		// wrapper itself instead of at mpStr, see SubstringBase::SetStart()
+		sSize			mSelfOffset;
+
 	protected:
 		friend void Swap(WrapperStringBase& wrapStr1, WrapperStringBase& wrapStr2)
 		{
 			using Quartz::Swap;
 			Swap(wrapStr1.mLength, wrapStr2.mLength);
+			Swap(wrapStr1.mHash, wrapStr2.mHash);
 
 			// @TODO: figure out why a simple swap doesn't work on const char*s
 			const CharType* temp = wrapStr1.mpStr;
@@ -509,19 +636,23 @@ namespace Quartz
 
 	public:
 		WrapperStringBase()
-			: mLength(0), mpStr(nullptr), mHash(QUARTZ_HASH_INVALID) {}
+			: mLength(0), mpStr(nullptr), mHash(QUARTZ_HASH_INVALID), mSelfOffset(0) {}
 
 		WrapperStringBase(const CharType* pStr)
-			: mLength(StrLen<CharType>(pStr)), mpStr(pStr), mHash(QUARTZ_HASH_INVALID) {}
+			: mLength(StrLen<CharType>(pStr)), mpStr(pStr), mHash(QUARTZ_HASH_INVALID), mSelfOffset(0) {}
 
 		WrapperStringBase(const CharType* pStr, uSize length)
-			: mLength(length), mpStr(pStr), mHash(QUARTZ_HASH_INVALID)
+			: mLength(length), mpStr(pStr), mHash(QUARTZ_HASH_INVALID), mSelfOffset(0)
 		{
 #if DEBUG_STRING_LENGTH_CHECK
 			assert(!(length > 0 && length > StrLen(pStr)));
 #endif
 		}
 
+		// Copies of a Substring point at its characters, not at their offset
+		WrapperStringBase(const WrapperStringBase& wrapStr)
+			: mLength(wrapStr.mLength), mpStr(wrapStr.Str()), mHash(wrapStr.mHash), mSelfOffset(0) {}
+
 		bool StartsWith(const WrapperStringBase& str) const
 		{
 			if (str.Length() > Length())
@@ -543,57 +674,46 @@ namespace Quartz
 			return true;
 		}
 
+		/* Returns the index of the first occurrence of str, or Length() if not found */
 		uSize Find(const WrapperStringBase& str) const
 		{
-			const CharType* foundStr = StrStrMax(Str(), str.Str(), Length());
-
-			if (!foundStr)
-			{
-				return Length();
-			}
-			else
-			{
-				return (uSize)(foundStr - Str()) / sizeof(CharType);
-			}
+			const CharType* pFound = StrFind(Str(), Length(), str.Str(), str.Length());
+			return pFound ? static_cast<uSize>(pFound - Str()) : Length();
 		}
 
+		/* Returns the index of the last occurrence of str, or Length() if not found */
 		uSize FindReverse(const WrapperStringBase& str) const
 		{
-			const CharType* pStart = Str();
-			const CharType* pSubStr = pStart + (Length() - 1);
-			uSize revLength = 1;
-
-			while (pSubStr >= pStart)
-			{
-				WrapperStringBase testStr(pSubStr, revLength);
-
-				if (testStr.StartsWith(str) || pSubStr == (pStart + str.Length() - 1))
-				{
-					return Length() - revLength + str.Length() - 1;
-				}
-
-				pSubStr--;
-				revLength++;
-			}
-
-			return 0;
+			const CharType* pFound = StrFindReverse(Str(), Length(), str.Str(), str.Length());
+			return pFound ? static_cast<uSize>(pFound - Str()) : Length();
 		}
 
 		bool operator==(const StringBase& str) const
 		{
 			return (mLength == str.Length()) &&
-				(StrCmpCount(Str(), str.Str(), mLength) == 0);
+				_StrEqualCount(Str(), str.Str(), mLength);
 		}
 
 		bool operator==(const WrapperStringBase& wrapStr) const
 		{
-			return (mLength == wrapStr.mLength) &&
-				(StrCmpCount(Str(), wrapStr.Str(), mLength) == 0);
+			if (mLength != wrapStr.mLength)
+			{
+				return false;
+			}
+
+			// Strings with different cached hashes differ
+			if (mHash != wrapStr.mHash && mHash != QUARTZ_HASH_INVALID && wrapStr.mHash != QUARTZ_HASH_INVALID)
+			{
+				return false;
+			}
+
+			return _StrEqualCount(Str(), wrapStr.Str(), mLength);
 		}
 
 		bool operator==(const CharType* pStr) const
 		{
-			return StrCmpCount(Str(), pStr, mLength) == 0;
+			return (StrCmpCount(Str(), pStr, mLength) == 0) &&
+				(pStr[mLength] == '\0');
 		}
 
 		bool operator!=(const StringBase& str) const
@@ -619,21 +739,28 @@ namespace Quartz
 
 		operator StringBase()
 		{
-			return String(Str(), mLength);
+			return StringBase(Str(), mLength);
 		}
 
 		const CharType* Str() const
 		{
-			return reinterpret_cast<const CharType*>(mpStr);
+			if (mSelfOffset != 0)
+			{
+				return reinterpret_cast<const CharType*>(reinterpret_cast<const uInt8*>(this) + mSelfOffset);
+			}
+
+			return mpStr;
 		}
 
+		/* Returns the characters for writing, and resets the cached hash, see StringBase::Data() */
 		CharType* Data()
 		{
-			return reinterpret_cast<CharType*>(mpStr);
+			mHash = QUARTZ_HASH_INVALID;
+			return const_cast<CharType*>(Str());
 		}
 
-		operator const CharType* () { return mpStr; }
-		operator CharType* () { return mpStr; }
+		operator const CharType* () { return Str(); }
+		operator CharType* () { return Data(); }
 
 		uSize Length() const
 		{
@@ -645,6 +772,10 @@ namespace Quartz
 			return mLength == 0;
 		}
 
+		/*
+			Caches the hash of the viewed characters. The characters belong
+			to another string, so only writes through Data() reset it.
+		*/
 		hash64 GetHash()
 		{
 			if (mHash != QUARTZ_HASH_INVALID)
@@ -653,22 +784,7 @@ namespace Quartz
 			}
 			else
 			{
-				// MurmurOAAT64 Hash
-
-				const CharType* pStr = Str();
-				const CharType* pStrEnd = Str() + Length();
-
-				uInt64 hash = 525201411107845655ull;
-
-				while (pStr != pStrEnd && *pStr)
-				{
-					hash ^= *pStr;
-					hash *= 0x5bd1e9955bd1e995;
-					hash ^= hash >> 47;
-					pStr++;
-				}
-
-				mHash = static_cast<hash64>(hash);
+				mHash = HashBytes(Str(), Length() * sizeof(CharType));
 
 				return mHash;
 			}
@@ -700,6 +816,9 @@ namespace Quartz
 			Swap(substr1.mLength, substr2.mLength);
 			Swap(substr1.mSrcString, substr2.mSrcString);
 			Swap(substr1.mHash, substr2.mHash);
+
+			// Offsets from the substring are the same in both, so they swap as is
+			Swap(substr1.mSelfOffset, substr2.mSelfOffset);
 			
 			// @TODO: figure out why a simple swap doesn't work on const char*s
 			const CharType* temp = substr1.mpStr;
@@ -707,26 +826,69 @@ namespace Quartz
 			substr2.mpStr = temp;
 		}
 
+		/*
+			Points the substring at index start of mSrcString. Small strings
+			are copied inline rather than shared, so a substring of a small
+			string points into its own mSrcString. That copy moves with the
+			substring, even when an Array moves it with MemMove, so it is
+			found by its offset from the substring rather than by address.
+		*/
+		void SetStart(uSize start)
+		{
+			if (mSrcString.IsSmall())
+			{
+				const WrapperStringBase* pBase = this;
+
+				this->mpStr			= nullptr;
+				this->mSelfOffset	= reinterpret_cast<const uInt8*>(mSrcString.Str() + start) -
+					reinterpret_cast<const uInt8*>(pBase);
+			}
+			else
+			{
+				this->mpStr			= mSrcString.Str() + start;
+				this->mSelfOffset	= 0;
+			}
+		}
+
+		/* Returns the index of the first character in mSrcString */
+		uSize Start() const
+		{
+			return this->Str() ? static_cast<uSize>(this->Str() - mSrcString.Str()) : 0;
+		}
+
 	public:
 		SubstringBase()
 			: WrapperStringBase(nullptr, 0), mSrcString() {}
 
 		SubstringBase(const SubstringBase& substr)
-			: WrapperStringBase(substr.mpStr, substr.mLength),
-			mSrcString(substr.mSrcString) {}
+			: WrapperStringBase(substr.Str(), substr.mLength),
+			mSrcString(substr.mSrcString)
+		{
+			if (substr.Str())
+			{
+				SetStart(substr.Start());
+			}
+		}
 
 		SubstringBase(SubstringBase&& rSubstr) noexcept
+			: SubstringBase()
 		{
 			Swap(*this, rSubstr);
 		}
 
 		SubstringBase(const StringBase& str, uSize start, uSize end)
 			: WrapperStringBase(str.Str() + start, end - start), 
-			mSrcString(str) { }
+			mSrcString(str)
+		{
+			SetStart(start);
+		}
 
 		SubstringBase(const SubstringBase& substr, uSize start, uSize end)
 			: WrapperStringBase(substr.Str() + start, end - start),
-			mSrcString(substr.mSrcString) { }
+			mSrcString(substr.mSrcString)
+		{
+			SetStart(substr.Start() + start);
+		}
 
 		SubstringBase Substring(uSize start, uSize end) const
 		{
@@ -736,7 +898,33 @@ namespace Quartz
 
 		SubstringBase Substring(uSize start) const
 		{
-			return SubstringBase(*this, start, Length());
+			return SubstringBase(*this, start, this->Length());
+		}
+
+		/* Returns the fields between any of the characters in delims, see SplitRangeBase */
+		SplitRangeBase<CharType> Split(const WrapperStringBase& delims) const
+		{
+			return SplitRangeBase<CharType>(*this, delims, SplitRangeBase<CharType>::SPLIT_FIELDS);
+		}
+
+		/* Returns the lines, without their \n or \r\n terminators */
+		SplitRangeBase<CharType> Lines() const
+		{
+			static const CharType newline[] = { '\n' };
+			return SplitRangeBase<CharType>(*this, WrapperStringBase(newline, 1), SplitRangeBase<CharType>::SPLIT_LINES);
+		}
+
+		/* Returns the runs of characters between whitespace */
+		SplitRangeBase<CharType> Tokens() const
+		{
+			static const CharType whitespace[] = { ' ', '\n', '\t', '\r' };
+			return SplitRangeBase<CharType>(*this, WrapperStringBase(whitespace, 4), SplitRangeBase<CharType>::SPLIT_TOKENS);
+		}
+
+		/* Returns the runs of characters between any of the characters in delims */
+		SplitRangeBase<CharType> Tokens(const WrapperStringBase& delims) const
+		{
+			return SplitRangeBase<CharType>(*this, delims, SplitRangeBase<CharType>::SPLIT_TOKENS);
 		}
 
 		SubstringBase TrimWhitespace() const
@@ -746,13 +934,13 @@ namespace Quartz
 
 		SubstringBase TrimWhitespaceForward() const
 		{
-			if (IsEmpty())
+			if (this->IsEmpty())
 			{
 				return *this;
 			}
 
 			uSize idx = 0;
-			while (idx < mLength && IsWhitespace(mpStr[idx]))
+			while (idx < this->Length() && IsWhitespace(this->Str()[idx]))
 			{
 				idx++;
 			}
@@ -762,13 +950,13 @@ namespace Quartz
 
 		SubstringBase TrimWhitespaceReverse() const
 		{
-			if (IsEmpty())
+			if (this->IsEmpty())
 			{
 				return *this;
 			}
 
-			uSize idx = mLength - 1;
-			while (idx > 0 && IsWhitespace(mpStr[idx]))
+			uSize idx = this->Length() - 1;
+			while (idx > 0 && IsWhitespace(this->Str()[idx]))
 			{
 				idx--;
 			}
@@ -785,51 +973,259 @@ namespace Quartz
 		}
 	};
 
+	/*
+		A lazy range of the Substrings of a string between delimiter
+		characters. Each step scans for the next delimiter, a vector at a
+		time for up to STRING_MAX_SIMD_SET delimiters (see StrFindAny), and
+		yields a Substring sharing the source's buffer, so splitting
+		allocates nothing.
+
+		SPLIT_FIELDS keeps empty fields, so "a,,b" splits on "," into "a",
+		"" and "b", and an empty string into one empty field. SPLIT_TOKENS
+		skips them. SPLIT_LINES splits on '\n', drops a '\r' before it and
+		yields no empty line after a final '\n'.
+
+		The delimiters are not copied and must outlive the range, as string
+		literals do.
+	*/
+	template<typename CharType>
+	class SplitRangeBase
+	{
+	public:
+		using SubstringType		= SubstringBase<CharType>;
+		using WrapperStringType	= WrapperStringBase<CharType>;
+
+		enum SplitMode
+		{
+			SPLIT_FIELDS,
+			SPLIT_TOKENS,
+			SPLIT_LINES
+		};
+
+		class Iterator
+		{
+		private:
+			constexpr static uSize END = ~uSize(0);
+
+			const SplitRangeBase*	mpRange;
+			uSize					mStart;
+			uSize					mEnd;
+
+		private:
+			/* Finds the piece at or after start, or becomes End() */
+			void Seek(uSize start)
+			{
+				const uSize length = mpRange->mSource.Length();
+
+				if (mpRange->mMode == SPLIT_TOKENS)
+				{
+					const CharType* pStr = mpRange->mSource.Str();
+
+					while (start < length && _StrIsAny(pStr[start], mpRange->mDelims.Str(), mpRange->mDelims.Length()))
+					{
+						start++;
+					}
+
+					if (start == length)
+					{
+						mStart = END;
+						return;
+					}
+				}
+
+				mStart	= start;
+				mEnd	= mpRange->FindDelim(start);
+			}
+
+		public:
+			Iterator()
+				: mpRange(nullptr), mStart(END), mEnd(END) {}
+
+			Iterator(const SplitRangeBase* pRange, uSize start)
+				: mpRange(pRange), mStart(END), mEnd(END)
+			{
+				Seek(start);
+			}
+
+			SubstringType operator*() const
+			{
+				uSize end = mEnd;
+
+				if (mpRange->mMode == SPLIT_LINES && end > mStart && mpRange->mSource.Str()[end - 1] == CharType('\r'))
+				{
+					end--;
+				}
+
+				return mpRange->mSource.Substring(mStart, end);
+			}
+
+			Iterator& operator++()
+			{
+				const uSize length = mpRange->mSource.Length();
+
+				// The last piece ends at the end of the source, and a final
+				// line terminator does not start another line
+				if (mEnd == length || (mpRange->mMode == SPLIT_LINES && mEnd + 1 == length))
+				{
+					mStart = END;
+				}
+				else
+				{
+					Seek(mEnd + 1);
+				}
+
+				return *this;
+			}
+
+			Iterator operator++(int)
+			{
+				Iterator temp(*this);
+				++(*this);
+				return temp;
+			}
+
+			bool operator==(const Iterator& it) const
+			{
+				return mStart == it.mStart;
+			}
+
+			bool operator!=(const Iterator& it) const
+			{
+				return !(*this == it);
+			}
+		};
+
+	private:
+		SubstringType		mSource;
+		WrapperStringType	mDelims;
+		SplitMode			mMode;
+
+		/* Returns the index of the next delimiter at or after start, or the source length */
+		uSize FindDelim(uSize start) const
+		{
+			const CharType* pStr = mSource.Str();
+			const CharType* pDelim = StrFindAny(pStr + start, mSource.Length() - start, mDelims.Str(), mDelims.Length());
+
+			return pDelim ? static_cast<uSize>(pDelim - pStr) : mSource.Length();
+		}
+
+	public:
+		SplitRangeBase(const SubstringType& source, const WrapperStringType& delims, SplitMode mode)
+			: mSource(source), mDelims(delims), mMode(mode) {}
+
+		Iterator Begin() const
+		{
+			// Lines of an empty string are empty, fields are one empty field
+			if (mMode == SPLIT_LINES && mSource.Length() == 0)
+			{
+				return End();
+			}
+
+			return Iterator(this, 0);
+		}
+
+		Iterator End() const
+		{
+			return Iterator();
+		}
+
+		bool IsEmpty() const
+		{
+			return Begin() == End();
+		}
+
+		// for-each functions:
+
+		Iterator begin() const
+		{
+			return Begin();
+		}
+
+		Iterator end() const
+		{
+			return End();
+		}
+	};
+
 	using StringA			= StringBase<char>;
 	using StringW			= StringBase<wchar_t>;
 	using WrapperStringA	= WrapperStringBase<char>;
 	using WrapperStringW	= WrapperStringBase<wchar_t>;
 	using SubstringA		= SubstringBase<char>;
 	using SubstringW		= SubstringBase<wchar_t>;
+	using SplitRangeA		= SplitRangeBase<char>;
+	using SplitRangeW		= SplitRangeBase<wchar_t>;
 
 	using String			= StringA;
 	using WrapperString		= WrapperStringA;
 	using Substring			= SubstringA;
+	using SplitRange		= SplitRangeA;
+
+	/*
+		StrLen, StrCmp and StrCmpCount scan a vector at a time with SSE2 or
+		AVX2 when available, see StringSearch.h. Comparisons return the
+		difference of the first differing characters (as unsigned char for
+		char), so only their sign matches strcmp.
+	*/
 
 	template<>
 	inline uSize StrLen<char>(const char* pStr)
 	{
+#if defined(QUARTZ_STRING_SSE2)
+		return _SimdStrLen(pStr);
+#else
 		return static_cast<uSize>(strlen(pStr));
+#endif
 	}
 
 	template<>
 	inline uSize StrLen<wchar_t>(const wchar_t* pStr)
 	{
+#if defined(QUARTZ_STRING_SSE2)
+		return _SimdStrLen(pStr);
+#else
 		return static_cast<uSize>(wcslen(pStr));
+#endif
 	}
 
 	template<>
 	inline sSize StrCmp<char>(const char* pStr1, const char* pStr2)
 	{
+#if defined(QUARTZ_STRING_SSE2)
+		return _SimdStrCmp(pStr1, pStr2, static_cast<uSize>(-1));
+#else
 		return static_cast<sSize>(strcmp(pStr1, pStr2));
+#endif
 	}
 
 	template<>
 	inline sSize StrCmp<wchar_t>(const wchar_t* pStr1, const wchar_t* pStr2)
 	{
+#if defined(QUARTZ_STRING_SSE2)
+		return _SimdStrCmp(pStr1, pStr2, static_cast<uSize>(-1));
+#else
 		return static_cast<sSize>(wcscmp(pStr1, pStr2));
+#endif
 	}
 
 	template<>
 	inline sSize StrCmpCount<char>(const char* pStr1, const char* pStr2, uSize count)
 	{
+#if defined(QUARTZ_STRING_SSE2)
+		return _SimdStrCmp(pStr1, pStr2, count);
+#else
 		return static_cast<sSize>(strncmp(pStr1, pStr2, count));
+#endif
 	}
 
 	template<>
 	inline sSize StrCmpCount<wchar_t>(const wchar_t* pStr1, const wchar_t* pStr2, uSize count)
 	{
+#if defined(QUARTZ_STRING_SSE2)
+		return _SimdStrCmp(pStr1, pStr2, count);
+#else
 		return static_cast<sSize>(wcsncmp(pStr1, pStr2, count));
+#endif
 	}
 
 	template<>
@@ -844,34 +1240,30 @@ namespace Quartz
 		return wcsstr(pStr, pDelim);
 	}
 
+	/*
+		Finds pDelim within the first maxLength characters of pStr, which
+		must all be readable, see StrFind(). Returns nullptr if not found.
+	*/
 	template<>
 	inline const char* StrStrMax<char>(const char* pStr, const char* pDelim, uSize maxLength)
 	{
-		// @TODO: Find a better alternative that can actually stop at maxLength;
-		const char* pFound = strstr(pStr, pDelim);
-
-		if (pFound - pStr > maxLength)
-		{
-			return pStr + maxLength;
-		}
-
-		return pFound;
+		return StrFind(pStr, maxLength, pDelim, StrLen(pDelim));
 	}
 
 	template<>
 	inline const wchar_t* StrStrMax<wchar_t>(const wchar_t* pStr, const wchar_t* pDelim, uSize maxLength)
 	{
-		// @TODO: Find a better alternative that can actually stop at maxLength;
-		const wchar_t* pFound = wcsstr(pStr, pDelim);
-
-		if (pFound - pStr > maxLength)
-		{
-			return pStr + maxLength;
-		}
-
-		return pFound;
+		return StrFind(pStr, maxLength, pDelim, StrLen(pDelim));
 	}
 
+	/*
+		String hashes. StringBase, WrapperStringBase, SubstringBase and
+		character pointers all hash their characters with HashBytes, so
+		the same text hashes identically whatever holds it, and any of
+		them can look up the others in a Map or Set. Substrings hash in
+		place. Seeded hashes use the same function with the table's seed,
+		see HashSeeded(), so a seed of 0 matches the unseeded hash.
+	*/
 	template<>
 	inline hash64 Hash<StringA>(const StringA& value)
 	{
@@ -908,6 +1300,117 @@ namespace Quartz
 		return value.GetHash();
 	}
 
+	template<>
+	inline hash64 Hash<const char*>(const char* const& value)
+	{
+		return WrapperStringA(value).GetHash();
+	}
+
+	template<>
+	inline hash64 Hash<const wchar_t*>(const wchar_t* const& value)
+	{
+		return WrapperStringW(value).GetHash();
+	}
+
+	/* Seeded string hashes, see HashSeeded() */
+	template<typename CharType>
+	inline hash64 _HashStringSeeded(const CharType* pStr, uSize length, hash64 seed)
+	{
+		return HashBytes(pStr, length * sizeof(CharType), seed);
+	}
+
+	template<typename CharType>
+	struct SeededHasher<StringBase<CharType>>
+	{
+		static hash64 HashValue(const StringBase<CharType>& value, hash64 seed)
+		{
+			return _HashStringSeeded(value.Str(), value.Length(), seed);
+		}
+	};
+
+	template<typename CharType>
+	struct SeededHasher<WrapperStringBase<CharType>>
+	{
+		static hash64 HashValue(const WrapperStringBase<CharType>& value, hash64 seed)
+		{
+			return _HashStringSeeded(value.Str(), value.Length(), seed);
+		}
+	};
+
+	template<typename CharType>
+	struct SeededHasher<SubstringBase<CharType>>
+	{
+		static hash64 HashValue(const SubstringBase<CharType>& value, hash64 seed)
+		{
+			return _HashStringSeeded(value.Str(), value.Length(), seed);
+		}
+	};
+
+	template<typename CharType>
+	struct SeededHasher<const CharType*, typename std::enable_if<
+		std::is_same<CharType, char>::value || std::is_same<CharType, wchar_t>::value>::type>
+	{
+		static hash64 HashValue(const CharType* const& value, hash64 seed)
+		{
+			return _HashStringSeeded(value, StrLen(value), seed);
+		}
+	};
+
+	/* Strings, Substrings, WrapperStrings and character pointers look each other up in place */
+	template<typename LookupType>
+	struct _StringLookupChar
+	{
+		using Type = void;
+	};
+
+	template<typename CharType>
+	struct _StringLookupChar<StringBase<CharType>>
+	{
+		using Type = CharType;
+	};
+
+	template<typename CharType>
+	struct _StringLookupChar<WrapperStringBase<CharType>>
+	{
+		using Type = CharType;
+	};
+
+	template<typename CharType>
+	struct _StringLookupChar<SubstringBase<CharType>>
+	{
+		using Type = CharType;
+	};
+
+	template<typename CharType>
+	struct _StringLookupChar<const CharType*>
+	{
+		using Type = CharType;
+	};
+
+	template<typename CharType>
+	struct _StringLookupChar<CharType*>
+	{
+		using Type = CharType;
+	};
+
+	template<typename KeyCharType, typename LookupType>
+	struct IsTransparentLookup<StringBase<KeyCharType>, LookupType>
+	{
+		constexpr static bool value = std::is_same<typename _StringLookupChar<LookupType>::Type, KeyCharType>::value;
+	};
+
+	template<typename KeyCharType, typename LookupType>
+	struct IsTransparentLookup<WrapperStringBase<KeyCharType>, LookupType>
+	{
+		constexpr static bool value = std::is_same<typename _StringLookupChar<LookupType>::Type, KeyCharType>::value;
+	};
+
+	template<typename KeyCharType, typename LookupType>
+	struct IsTransparentLookup<SubstringBase<KeyCharType>, LookupType>
+	{
+		constexpr static bool value = std::is_same<typename _StringLookupChar<LookupType>::Type, KeyCharType>::value;
+	};
+
 	// @Todo: Speed up
 	inline StringW StringAToStringW(const StringA& strA)
 	{
@@ -0,0 +1,330 @@
+#pragma once
+
+#include "String.h"
+#include "Utility/NumberFormat.h"
+#include "Utility/Swap.h"
+
+#include <new>
+#include <type_traits>
+
+namespace Quartz
+{
+	/*====================================================
+	|               QUARTZLIB STRING BUILDER             |
+	=====================================================*/
+
+	template<typename Type>
+	struct _IsCharType
+	{
+		constexpr static bool value = std::is_same<Type, char>::value || std::is_same<Type, wchar_t>::value ||
+			std::is_same<Type, char16_t>::value || std::is_same<Type, char32_t>::value;
+	};
+
+	/*
+		Builds a string from many pieces in amortized linear time. Pieces
+		are appended to a buffer that grows geometrically, unlike
+		StringBase::Append() which copies both sides into a new string.
+
+		The buffer is laid out as a heap string buffer, [StringMeta][chars],
+		with room for the header reserved up front, so ToString() hands the
+		buffer over to the String without copying the characters. Strings
+		short enough to be stored inline are copied instead, and the
+		builder keeps its buffer.
+	*/
+	template<typename CharType>
+	class StringBuilderBase
+	{
+	public:
+		using StringType		= StringBase<CharType>;
+		using WrapperStringType	= WrapperStringBase<CharType>;
+		using SubstringType		= SubstringBase<CharType>;
+
+		constexpr static uSize	MIN_CAPACITY	= 64;
+		constexpr static float	GROWTH_FACTOR	= 2.0f;
+
+	private:
+		using MetaType = typename StringType::StringMeta;
+
+		constexpr static uSize metaSize = StringType::metaSize;
+
+		uInt8*	mpData;
+		uSize	mLength;
+		uSize	mCapacity;
+
+	private:
+		friend void Swap(StringBuilderBase& builder1, StringBuilderBase& builder2)
+		{
+			using Quartz::Swap;
+			Swap(builder1.mpData, builder2.mpData);
+			Swap(builder1.mLength, builder2.mLength);
+			Swap(builder1.mCapacity, builder2.mCapacity);
+		}
+
+		CharType* Chars()
+		{
+			return reinterpret_cast<CharType*>(mpData + metaSize);
+		}
+
+		/* Reallocates the buffer to hold capacity characters and a terminator */
+		void Reallocate(uSize capacity)
+		{
+			uInt8* pData = new uInt8[metaSize + (capacity + 1) * sizeof(CharType)];
+
+			if (mpData)
+			{
+				MemCopy(pData + metaSize, mpData + metaSize, mLength * sizeof(CharType));
+				delete[] mpData;
+			}
+
+			mpData		= pData;
+			mCapacity	= capacity;
+		}
+
+		/* Makes room for count more characters, returns where to write them */
+		CharType* Extend(uSize count)
+		{
+			if (mLength + count > mCapacity)
+			{
+				uSize capacity = static_cast<uSize>(mCapacity * GROWTH_FACTOR);
+
+				if (capacity < mLength + count)
+				{
+					capacity = mLength + count;
+				}
+
+				Reallocate(capacity > MIN_CAPACITY ? capacity : MIN_CAPACITY);
+			}
+
+			CharType* pOut = Chars() + mLength;
+			mLength += count;
+
+			return pOut;
+		}
+
+		template<typename IntType>
+		void AppendInteger(IntType value)
+		{
+			CharType* pOut = Extend(NUMBER_MAX_CHARS);
+
+			const uSize count = std::is_signed<IntType>::value ?
+				FormatInt(static_cast<int64>(value), pOut) : FormatUInt(static_cast<uInt64>(value), pOut);
+
+			mLength -= NUMBER_MAX_CHARS - count;
+		}
+
+		template<typename FloatType>
+		void AppendFloat(FloatType value)
+		{
+			CharType* pOut = Extend(NUMBER_MAX_CHARS);
+			mLength -= NUMBER_MAX_CHARS - FormatFloat(value, pOut);
+		}
+
+	public:
+		StringBuilderBase()
+			: mpData(nullptr), mLength(0), mCapacity(0) {}
+
+		explicit StringBuilderBase(uSize capacity)
+			: StringBuilderBase()
+		{
+			Reserve(capacity);
+		}
+
+		StringBuilderBase(const StringBuilderBase& builder)
+			: StringBuilderBase()
+		{
+			Append(builder.View());
+		}
+
+		StringBuilderBase(StringBuilderBase&& builder) noexcept
+			: StringBuilderBase()
+		{
+			Swap(*this, builder);
+		}
+
+		~StringBuilderBase()
+		{
+			delete[] mpData;
+		}
+
+		StringBuilderBase& operator=(StringBuilderBase builder)
+		{
+			Swap(*this, builder);
+			return *this;
+		}
+
+		/* Grows the buffer to hold capacity characters without reallocating */
+		void Reserve(uSize capacity)
+		{
+			if (capacity > mCapacity)
+			{
+				Reallocate(capacity);
+			}
+		}
+
+		StringBuilderBase& Append(const CharType* pStr, uSize length)
+		{
+			if (length == 0)
+			{
+				return *this;
+			}
+
+			// The characters may be in the buffer, as with Append(View()),
+			// so find them again by offset once Extend() has reallocated
+			if (mpData && pStr >= Chars() && pStr < Chars() + mCapacity)
+			{
+				const uSize offset = static_cast<uSize>(pStr - Chars());
+				CharType* pOut = Extend(length);
+
+				MemCopy(pOut, Chars() + offset, length * sizeof(CharType));
+			}
+			else
+			{
+				MemCopy(Extend(length), pStr, length * sizeof(CharType));
+			}
+
+			return *this;
+		}
+
+		StringBuilderBase& Append(const CharType* pStr)
+		{
+			return Append(pStr, StrLen(pStr));
+		}
+
+		StringBuilderBase& Append(const StringType& str)
+		{
+			return Append(str.Str(), str.Length());
+		}
+
+		StringBuilderBase& Append(const WrapperStringType& str)
+		{
+			return Append(str.Str(), str.Length());
+		}
+
+		StringBuilderBase& Append(CharType c)
+		{
+			*Extend(1) = c;
+			return *this;
+		}
+
+		/* Appends count copies of c */
+		StringBuilderBase& Append(CharType c, uSize count)
+		{
+			CharType* pOut = Extend(count);
+
+			for (uSize i = 0; i < count; i++)
+			{
+				pOut[i] = c;
+			}
+
+			return *this;
+		}
+
+		StringBuilderBase& Append(bool value)
+		{
+			static const CharType trueText[]	= { 't', 'r', 'u', 'e' };
+			static const CharType falseText[]	= { 'f', 'a', 'l', 's', 'e' };
+
+			return value ? Append(trueText, 4) : Append(falseText, 5);
+		}
+
+		/* Appends a character of another character type, such as 'c' to a wide builder */
+		template<typename OtherCharType>
+		typename std::enable_if<_IsCharType<OtherCharType>::value &&
+			!std::is_same<OtherCharType, CharType>::value, StringBuilderBase&>::type
+		Append(OtherCharType c)
+		{
+			return Append(static_cast<CharType>(c));
+		}
+
+		/* Appends the decimal digits of an integer */
+		template<typename IntType>
+		typename std::enable_if<std::is_integral<IntType>::value &&
+			!std::is_same<IntType, bool>::value && !_IsCharType<IntType>::value, StringBuilderBase&>::type
+		Append(IntType value)
+		{
+			AppendInteger(value);
+			return *this;
+		}
+
+		/* Appends the shortest representation of a floating point value that reads back exactly */
+		StringBuilderBase& Append(double value)
+		{
+			AppendFloat(value);
+			return *this;
+		}
+
+		StringBuilderBase& Append(float value)
+		{
+			AppendFloat(value);
+			return *this;
+		}
+
+		template<typename ValueType>
+		StringBuilderBase& operator+=(const ValueType& value)
+		{
+			return Append(value);
+		}
+
+		/*
+			Returns the built string and empties the builder. Long strings
+			take over the builder's buffer, including its spare capacity.
+		*/
+		StringType ToString()
+		{
+			if (mLength <= StringType::SMALL_CAPACITY)
+			{
+				StringType result = mLength ? StringType(Chars(), mLength) : StringType();
+				Clear();
+
+				return result;
+			}
+
+			new (mpData) MetaType(1, mLength, QUARTZ_HASH_INVALID);
+			Chars()[mLength] = CharType(0);
+
+			// The default string is small and owns no storage, so it can be overwritten
+			StringType result;
+			result.mpData = mpData;
+			result.mSmall[StringType::SMALL_BYTES - 1] = StringType::HEAP_TAG;
+
+			mpData		= nullptr;
+			mLength		= 0;
+			mCapacity	= 0;
+
+			return result;
+		}
+
+		/* Returns a view of the characters appended so far, valid until the next append */
+		WrapperStringType View() const
+		{
+			return mpData ? WrapperStringType(reinterpret_cast<const CharType*>(mpData + metaSize), mLength) :
+				WrapperStringType(nullptr, 0);
+		}
+
+		/* Empties the builder, keeping its buffer */
+		void Clear()
+		{
+			mLength = 0;
+		}
+
+		uSize Length() const
+		{
+			return mLength;
+		}
+
+		uSize Capacity() const
+		{
+			return mCapacity;
+		}
+
+		bool IsEmpty() const
+		{
+			return mLength == 0;
+		}
+	};
+
+	using StringBuilderA	= StringBuilderBase<char>;
+	using StringBuilderW	= StringBuilderBase<wchar_t>;
+
+	using StringBuilder		= StringBuilderA;
+}
\ No newline at end of file
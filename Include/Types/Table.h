@@ -2,8 +2,19 @@
 
 #include "Types.h"
 #include "Array.h"
+#include "Memory/Memory.h"
 #include "Utility/Swap.h"
 #include "Utility/Iterator.h"
+#include "Utility/Hash.h"
+
+// Set to 1 to track rehash counts and timings in TableStats
+#ifndef QUARTZ_TABLE_STATS
+#define QUARTZ_TABLE_STATS 0
+#endif
+
+#if QUARTZ_TABLE_STATS
+#include <chrono>
+#endif
 
 namespace Quartz
 {
@@ -43,7 +54,7 @@ namespace Quartz
 			: hash(hash), keyValue(Move(keyValue)), probe(0), meta(0), used(true) {}
 
 		TableEntry(const TableEntry& entry)
-			: hash(entry.hash), keyValue(entry.keyValue), probe(0), used(entry.used), meta(0) {}
+			: hash(entry.hash), keyValue(entry.keyValue), probe(entry.probe), used(entry.used), meta(0) {}
 
 		TableEntry(TableEntry&& entry) noexcept
 			: TableEntry()
@@ -92,18 +103,69 @@ namespace Quartz
 		}
 	};
 
-	template<typename KeyValueType, typename HashType = uSize>
+	/*
+		The default Table sizing policy.
+
+		A custom policy is any type providing the same static members:
+			MAX_LOAD_FACTOR		- Load factor at which the table grows
+			GROWTH_FACTOR		- Capacity multiplier applied when growing
+			MIN_CAPACITY		- Initial and smallest capacity
+			SHRINK_LOAD_FACTOR	- Load factor at which Remove shrinks the table,
+								  or 0 to never shrink on Remove. Removing by
+								  Iterator never shrinks, see Table::Remove
+	*/
+	struct TablePolicy
+	{
+		constexpr static float	MAX_LOAD_FACTOR		= 0.85f;
+		constexpr static float	GROWTH_FACTOR		= 2.0f;
+		constexpr static uSize	MIN_CAPACITY		= 16;
+		constexpr static float	SHRINK_LOAD_FACTOR	= 0.0f;
+	};
+
+	constexpr uSize TABLE_PROBE_HISTOGRAM_SIZE = 16;
+
+	/*
+		A snapshot of the layout of a Table, see Table::GetStats().
+		Rehash counts and timings are only tracked when QUARTZ_TABLE_STATS
+		is enabled, and are 0 otherwise.
+	*/
+	struct TableStats
+	{
+		uSize	size;
+		uSize	capacity;
+		float	loadFactor;
+		float	averageProbe;
+		uSize	maxProbe;
+
+		// Entries by distance from their home slot, the last
+		// bucket also counts all longer probes
+		uSize	probeHistogram[TABLE_PROBE_HISTOGRAM_SIZE];
+
+		uSize	rehashCount;
+		uInt64	rehashNanoseconds;
+	};
+
+	template<typename KeyValueType, typename HashType = uSize, typename PolicyType = TablePolicy>
 	class Table
 	{
 	public:
-		using TableType = Table<KeyValueType, HashType>;
+		using TableType = Table<KeyValueType, HashType, PolicyType>;
 		using EntryType = TableEntry<KeyValueType, HashType>;
 
 		using Iterator		= Quartz::Iterator<TableType, EntryType>;
 		using ConstIterator = Quartz::ConstIterator<TableType, EntryType>;
 
-		constexpr static float	LOAD_FACTOR = 0.85f;
-		constexpr static uSize	INITAL_SIZE = 16;
+		constexpr static float	LOAD_FACTOR = PolicyType::MAX_LOAD_FACTOR;
+		constexpr static uSize	INITAL_SIZE = PolicyType::MIN_CAPACITY;
+
+		static_assert(PolicyType::MAX_LOAD_FACTOR > 0.0f && PolicyType::MAX_LOAD_FACTOR < 1.0f,
+			"Table MAX_LOAD_FACTOR must be between 0 and 1.");
+		static_assert(PolicyType::GROWTH_FACTOR > 1.0f,
+			"Table GROWTH_FACTOR must be greater than 1.");
+		static_assert(PolicyType::MIN_CAPACITY > 1,
+			"Table MIN_CAPACITY must be greater than 1.");
+		static_assert(PolicyType::SHRINK_LOAD_FACTOR * PolicyType::GROWTH_FACTOR < PolicyType::MAX_LOAD_FACTOR,
+			"Table SHRINK_LOAD_FACTOR must leave room to shrink without immediately regrowing.");
 
 	private:
 		friend void Swap(Table& table1, Table& table2)
@@ -113,6 +175,11 @@ namespace Quartz
 			Swap(table1.mSize, table2.mSize);
 			Swap(table1.mCapacity, table2.mCapacity);
 			Swap(table1.mThreshold, table2.mThreshold);
+			Swap(table1.mSeed, table2.mSeed);
+#if QUARTZ_TABLE_STATS
+			Swap(table1.mRehashCount, table2.mRehashCount);
+			Swap(table1.mRehashNanoseconds, table2.mRehashNanoseconds);
+#endif
 		}
 
 	private:
@@ -120,6 +187,12 @@ namespace Quartz
 		HashType mSize;
 		HashType mCapacity;
 		HashType mThreshold;
+		hash64 mSeed;
+
+#if QUARTZ_TABLE_STATS
+		uSize	mRehashCount		= 0;
+		uInt64	mRehashNanoseconds	= 0;
+#endif
 
 		inline uSize WrapIndex(uSize index) const
 		{
@@ -136,7 +209,8 @@ namespace Quartz
 			return GetIndex(hash) - index;
 		}
 
-		EntryType* FindEntry(HashType hash, const KeyValueType& keyValue)
+		template<typename LookupType>
+		EntryType* FindEntry(HashType hash, const LookupType& key)
 		{
 			HashType index	= GetIndex(hash);
 			HashType dist	= 0;
@@ -150,7 +224,7 @@ namespace Quartz
 					return nullptr;
 				}
 
-				if (entry.hash == hash && entry.keyValue == keyValue)
+				if (entry.hash == hash && entry.keyValue == key)
 				{
 					return &mTable.Data()[index];
 				}
@@ -162,7 +236,8 @@ namespace Quartz
 			return nullptr;
 		}
 
-		const EntryType* FindEntry(HashType hash, const KeyValueType& keyValue) const
+		template<typename LookupType>
+		const EntryType* FindEntry(HashType hash, const LookupType& key) const
 		{
 			HashType index	= GetIndex(hash);
 			HashType dist	= 0;
@@ -176,7 +251,7 @@ namespace Quartz
 					return nullptr;
 				}
 
-				if (entry.hash == hash && entry.keyValue == keyValue)
+				if (entry.hash == hash && entry.keyValue == key)
 				{
 					return &mTable.Data()[index];
 				}
@@ -197,7 +272,7 @@ namespace Quartz
 			{
 				if (mSize + 1 >= mThreshold)
 				{
-					ResizeRehash(NextGreaterPowerOf2(mCapacity));
+					ResizeRehash(NextCapacity());
 				}
 
 				return InsertImpl(hash, Forward<RKeyValueType>(keyValue));
@@ -249,9 +324,56 @@ namespace Quartz
 			}
 		}
 
+		void ShiftRemove(EntryType* pEntry)
+		{
+			// Backward-shift deletion: pull the following displaced entries
+			// back one slot so no probe chain is broken by the removal
+
+			uSize index = pEntry - mTable.Data();
+			uSize nextIndex = WrapIndex(index + 1);
+
+			while (!mTable.Data()[nextIndex].IsEmpty() && mTable.Data()[nextIndex].probe > 0)
+			{
+				Swap(mTable.Data()[index], mTable.Data()[nextIndex]);
+				--mTable.Data()[index].probe;
+
+				index = nextIndex;
+				nextIndex = WrapIndex(nextIndex + 1);
+			}
+
+			EntryType& removed = mTable.Data()[index];
+			removed.keyValue = KeyValueType();
+			removed.probe = 0;
+			removed.used = false;
+
+			mSize--;
+		}
+
+		void RemoveImpl(EntryType* pEntry)
+		{
+			ShiftRemove(pEntry);
+
+			if constexpr (PolicyType::SHRINK_LOAD_FACTOR > 0.0f)
+			{
+				if (mCapacity > PolicyType::MIN_CAPACITY && 
+					mSize < static_cast<HashType>(mCapacity * PolicyType::SHRINK_LOAD_FACTOR))
+				{
+					HashType shrunk = static_cast<HashType>(mCapacity / PolicyType::GROWTH_FACTOR);
+					HashType fitted = CapacityFor(mSize);
+
+					ResizeRehash(shrunk > fitted ? shrunk : fitted);
+				}
+			}
+		}
+
 		void ResizeRehash(HashType size)
 		{
+#if QUARTZ_TABLE_STATS
+			auto rehashStart = std::chrono::steady_clock::now();
+#endif
+
 			Table mNewTable(size);
+			mNewTable.mSeed = mSeed;
 
 			EntryType* pEntry = &mTable.Data()[0];
 
@@ -273,52 +395,56 @@ namespace Quartz
 			//}
 
 			Swap(mNewTable, *this);
-		}
 
-		///////////////////////////////////////////////////////////////////////
+#if QUARTZ_TABLE_STATS
+			auto rehashTime = std::chrono::steady_clock::now() - rehashStart;
 
-		uSize NextPowerOf2(uSize value)
-		{
-			uSize p = 1;
-			if (value && !(value & (value - 1)))
-				return value;
-
-			while (p < value)
-				p <<= 1;
+			mRehashCount		= mNewTable.mRehashCount + 1;
+			mRehashNanoseconds	= mNewTable.mRehashNanoseconds +
+				std::chrono::duration_cast<std::chrono::nanoseconds>(rehashTime).count();
+#endif
+		}
 
-			return p;
+		HashType NextCapacity() const
+		{
+			HashType grown = static_cast<HashType>(mCapacity * PolicyType::GROWTH_FACTOR);
+			return grown > mCapacity ? grown : mCapacity + 1;
 		}
 
-		uSize NextGreaterPowerOf2(uSize value)
+		static HashType ThresholdFor(HashType capacity)
 		{
-			//unsigned long idx;
-			//_BitScanReverse(&idx, (unsigned long)value);
-			//return (uSize)(1U << (idx + 1));
-			return NextPowerOf2(value + 1);
+			return static_cast<HashType>(capacity * PolicyType::MAX_LOAD_FACTOR);
 		}
 
-		///////////////////////////////////////////////////////////////////////
+		void MarkBounds()
+		{
+			mTable.Data()[0].first = true;
+			mTable.Data()[mCapacity - 1].last = true;
+		}
 
 	public:
 		Table()
-			: mTable(INITAL_SIZE, EntryType()), mSize(0), mCapacity(INITAL_SIZE),
-			mThreshold(INITAL_SIZE* LOAD_FACTOR)
+			: mTable(PolicyType::MIN_CAPACITY, EntryType()), mSize(0), mCapacity(PolicyType::MIN_CAPACITY),
+			mThreshold(ThresholdFor(PolicyType::MIN_CAPACITY)), mSeed(DefaultHashSeed())
 		{
-			mTable.Data()[0].first = true;
-			mTable.Data()[mCapacity - 1].last = true;
+			MarkBounds();
 		}
 
 		Table(HashType capacity)
-			: mTable(capacity, EntryType()), mSize(0), mCapacity(capacity),
-			mThreshold(capacity* LOAD_FACTOR)
+			: mTable(capacity > PolicyType::MIN_CAPACITY ? capacity : PolicyType::MIN_CAPACITY, EntryType()), mSize(0),
+			mCapacity(capacity > PolicyType::MIN_CAPACITY ? capacity : PolicyType::MIN_CAPACITY),
+			mThreshold(ThresholdFor(mCapacity)), mSeed(DefaultHashSeed())
 		{
-			mTable.Data()[0].first = true;
-			mTable.Data()[mCapacity - 1].last = true;
+			MarkBounds();
 		}
 
 		Table(const Table& table)
 			: mTable(table.mTable), mSize(table.mSize), mCapacity(table.mCapacity),
-			mThreshold(table.mThreshold) { }
+			mThreshold(table.mThreshold), mSeed(table.mSeed)
+		{
+			// Entry bound flags are positional and are not copied
+			MarkBounds();
+		}
 
 		Table(Table&& table) noexcept
 			: Table()
@@ -331,20 +457,20 @@ namespace Quartz
 		{
 			if (mSize + 1 >= mThreshold)
 			{
-				ResizeRehash(NextGreaterPowerOf2(mCapacity));
+				ResizeRehash(NextCapacity());
 			}
 
 			return InsertImpl(hash, Forward<RKeyValueType>(keyValue)).keyValue;
 		}
 
-		void Remove(HashType hash, const KeyValueType& keyValue)
+		template<typename LookupType>
+		void Remove(HashType hash, const LookupType& key)
 		{
-			EntryType* pEntry = FindEntry(hash, keyValue);
+			EntryType* pEntry = FindEntry(hash, key);
 
 			if (pEntry)
 			{
-				pEntry->used = false;
-				mSize--;
+				RemoveImpl(pEntry);
 			}
 		}
 
@@ -352,55 +478,122 @@ namespace Quartz
 		{
 			if (pEntry)
 			{
-				pEntry->used = false;
-				mSize--;
+				RemoveImpl(pEntry);
 			}
 		}
 
-		void Remove(Iterator& it)
+		/*
+			Removes the entry at it and returns an iterator to the entry
+			after it, so entries can be removed while iterating:
+
+				for (auto it = table.Begin(); it != table.End();)
+					it = cond ? table.Remove(it) : ++it;
+
+			Unlike the other overloads this never shrinks the table, as the
+			rehash would invalidate the iteration. Call Shrink() afterwards
+			if needed. Removal shifts the following displaced entries back
+			one slot, and if that wraps the entry in the first slot around
+			into the last slot, that entry is visited a second time.
+		*/
+		Iterator Remove(Iterator it)
 		{
-			if (it != End())
+			if (it == End())
 			{
-				it->used = false;
-				mSize--;
+				return it;
 			}
+
+			const bool lastSlot = it.pItr->IsLast();
+
+			ShiftRemove(it.pItr);
+
+			// The entry shifted into this slot has not been visited yet,
+			// unless it was pulled around from the first slot
+			if (lastSlot)
+			{
+				return End();
+			}
+
+			return it.pItr->IsEmpty() ? ++it : it;
 		}
 
-		bool Reserve(HashType size)
+		/*
+			Returns the smallest capacity that holds count entries
+			without growing, as permitted by the policy
+		*/
+		static HashType CapacityFor(HashType count)
 		{
-			if (size < mSize)
+			HashType capacity = static_cast<HashType>(count / PolicyType::MAX_LOAD_FACTOR) + 1;
+
+			while (static_cast<HashType>(capacity * PolicyType::MAX_LOAD_FACTOR) <= count)
+			{
+				++capacity;
+			}
+
+			return capacity > PolicyType::MIN_CAPACITY ? capacity : PolicyType::MIN_CAPACITY;
+		}
+
+		/*
+			Grows the table so count entries can be held without rehashing.
+			Returns false if count is less than the current size.
+		*/
+		bool Reserve(HashType count)
+		{
+			if (count < mSize)
 			{
 				// Cannot resize
 				return false;
 			}
 
-			ResizeRehash(NextPowerOf2(size));
+			HashType capacity = CapacityFor(count);
+
+			if (capacity > mCapacity)
+			{
+				ResizeRehash(capacity);
+			}
 
 			return true;
 		}
 
+		/* Shrinks the table to the smallest capacity that holds its entries */
 		void Shrink()
 		{
-			HashType newSize = NextPowerOf2(mSize);
+			HashType capacity = CapacityFor(mSize);
 
-			if (newSize != mSize)
+			if (capacity < mCapacity)
 			{
-				ResizeRehash(newSize);
+				ResizeRehash(capacity);
 			}
 		}
 
-		Iterator Find(HashType hash, const KeyValueType& keyValue)
+		/*
+			Finds an entry by hash and lookup key. The lookup key can be any
+			type comparable to KeyValueType with operator==, provided it was
+			hashed to the same value as the equivalent stored key.
+		*/
+		template<typename LookupType>
+		Iterator Find(HashType hash, const LookupType& key)
 		{
-			EntryType* pEntry = FindEntry(hash, keyValue);
+			EntryType* pEntry = FindEntry(hash, key);
 			return pEntry == nullptr ? End() : Iterator(pEntry);
 		}
 
-		ConstIterator Find(HashType hash, const KeyValueType& keyValue) const
+		template<typename LookupType>
+		ConstIterator Find(HashType hash, const LookupType& key) const
 		{
-			const EntryType* pEntry = FindEntry(hash, keyValue);
+			const EntryType* pEntry = FindEntry(hash, key);
 			return pEntry == nullptr ? End() : ConstIterator(pEntry);
 		}
 
+		/*
+			Prefetches the home entry of a hash. Prefetching a batch of
+			hashes before looking them up hides most of the cache miss
+			latency of large tables.
+		*/
+		void Prefetch(HashType hash) const
+		{
+			MemPrefetch(&mTable.Data()[GetIndex(hash)]);
+		}
+
 		template<typename RKeyValueType>
 		KeyValueType& FindInsert(HashType hash, RKeyValueType&& keyValue)
 		{
@@ -408,9 +601,10 @@ namespace Quartz
 			return entry.keyValue;
 		}
 
-		bool Contains(HashType hash, const KeyValueType& keyValue)
+		template<typename LookupType>
+		bool Contains(HashType hash, const LookupType& key) const
 		{
-			return Find(hash, keyValue) != End();
+			return FindEntry(hash, key) != nullptr;
 		}
 
 		Iterator Begin()
@@ -471,10 +665,48 @@ namespace Quartz
 		{
 			mTable.Clear();
 			mTable.Resize(mCapacity, EntryType());
-			mTable.Data()[mCapacity - 1].isLast = true;
+			mTable.Data()[0].first = true;
+			mTable.Data()[mCapacity - 1].last = true;
 			mSize = 0;
 		}
 
+		/*
+			Returns the seed the owning container hashes keys with, see
+			HashSeeded(). The Table itself only stores the hashes it is given.
+		*/
+		hash64 Seed() const
+		{
+			return mSeed;
+		}
+
+		/*
+			Changes the seed and rehashes every entry with
+			HashSeeded<KeyValueType>(). A seed of 0 disables seeding.
+		*/
+		void SetSeed(hash64 seed)
+		{
+			if (seed == mSeed)
+			{
+				return;
+			}
+
+			Table newTable(mCapacity);
+			newTable.mSeed = seed;
+
+			for (uSize i = 0; i < mCapacity; i++)
+			{
+				EntryType& entry = mTable.Data()[i];
+
+				if (!entry.IsEmpty())
+				{
+					const HashType hash = static_cast<HashType>(HashSeeded<KeyValueType>(entry.keyValue, seed));
+					newTable.Insert(hash, Move(entry.keyValue));
+				}
+			}
+
+			Swap(newTable, *this);
+		}
+
 		EntryType* Data()
 		{
 			return mTable.Data();
@@ -505,6 +737,43 @@ namespace Quartz
 			return mSize == 0;
 		}
 
+		/*
+			Walks every entry to collect load and probe statistics.
+			This is O(capacity) and intended for diagnostics only.
+		*/
+		TableStats GetStats() const
+		{
+			TableStats stats = {};
+			stats.size		= mSize;
+			stats.capacity	= mCapacity;
+			stats.loadFactor = mCapacity > 0 ? static_cast<float>(mSize) / mCapacity : 0.0f;
+
+			uInt64 totalProbe = 0;
+
+			for (uSize i = 0; i < mCapacity; i++)
+			{
+				const EntryType& entry = mTable.Data()[i];
+
+				if (entry.IsEmpty())
+				{
+					continue;
+				}
+
+				totalProbe += entry.probe;
+				stats.maxProbe = entry.probe > stats.maxProbe ? entry.probe : stats.maxProbe;
+				++stats.probeHistogram[entry.probe < TABLE_PROBE_HISTOGRAM_SIZE ? entry.probe : TABLE_PROBE_HISTOGRAM_SIZE - 1];
+			}
+
+			stats.averageProbe = mSize > 0 ? static_cast<float>(totalProbe) / mSize : 0.0f;
+
+#if QUARTZ_TABLE_STATS
+			stats.rehashCount		= mRehashCount;
+			stats.rehashNanoseconds	= mRehashNanoseconds;
+#endif
+
+			return stats;
+		}
+
 		Table& operator=(Table table)
 		{
 			Swap(*this, table);
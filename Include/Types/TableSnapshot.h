@@ -0,0 +1,388 @@
+#pragma once
+
+#include "Map.h"
+#include "Set.h"
+#include "Memory/Memory.h"
+
+#include <type_traits>
+#include <cstdint>
+#include <cstdio>
+
+namespace Quartz
+{
+	/*====================================================
+	|               QUARTZLIB TABLE SNAPSHOT             |
+	=====================================================*/
+
+	/*
+		A relocatable binary image of a Map or Set of trivially-copyable
+		keys and values. The Robin Hood entry layout is stored verbatim,
+		so a snapshot can be memory-mapped (see MappedFile) and queried in
+		place with MapSnapshot/SetSnapshot without deserializing.
+
+		Layout: [SnapshotHeader][padding][entries...]
+		All offsets are relative to the start of the snapshot. Data is
+		stored in native byte order and hashes must be stable between the
+		writing and reading process. The hash seed of the table is stored
+		with it, so seeded tables can be read back by any process; treat a
+		snapshot of a table seeded against hash flooding as a secret.
+	*/
+
+	constexpr uInt32 SNAPSHOT_MAGIC		= 0x4C425451; // "QTBL"
+	constexpr uInt32 SNAPSHOT_VERSION	= 2;
+	constexpr uSize  SNAPSHOT_ALIGNMENT	= 64;
+
+	struct SnapshotHeader
+	{
+		uInt32	magic;
+		uInt32	version;
+		uInt32	hashSize;
+		uInt32	entrySize;
+		uInt32	keySize;
+		uInt32	valueSize;
+		uInt64	size;
+		uInt64	capacity;
+		uInt64	entriesOffset;
+		uInt64	entriesBytes;
+		uInt64	checksum;
+		uInt64	seed;
+	};
+
+	template<typename KeyType, typename ValueType, typename HashType>
+	struct SnapshotEntry
+	{
+		HashType	hash;
+		uInt16		probe;
+		bool		used;
+		KeyType		key;
+		ValueType	value;
+	};
+
+	template<typename KeyType, typename HashType>
+	struct SnapshotEntry<KeyType, void, HashType>
+	{
+		HashType	hash;
+		uInt16		probe;
+		bool		used;
+		KeyType		key;
+	};
+
+	/* A word-at-a-time checksum of the snapshot entries */
+	inline uInt64 SnapshotChecksum(const void* pData, uInt64 sizeBytes)
+	{
+		const uInt8* pBytes = static_cast<const uInt8*>(pData);
+		uInt64 checksum = 0x9E3779B97F4A7C15ull ^ sizeBytes;
+
+		uInt64 i = 0;
+		for (; i + sizeof(uInt64) <= sizeBytes; i += sizeof(uInt64))
+		{
+			uInt64 word;
+			memcpy(&word, pBytes + i, sizeof(uInt64));
+			checksum = (checksum ^ word) * 0xFF51AFD7ED558CCDull;
+			checksum ^= checksum >> 32;
+		}
+
+		for (; i < sizeBytes; i++)
+		{
+			checksum = (checksum ^ pBytes[i]) * 0x100000001B3ull;
+		}
+
+		return checksum;
+	}
+
+	template<typename EntryType, typename TableType, typename FillFunc>
+	Array<uInt8> _WriteSnapshot(const TableType& table, uInt32 keySize, uInt32 valueSize, FillFunc fillEntry)
+	{
+		const uInt64 capacity		= table.Capacity();
+		const uInt64 entriesOffset	= (sizeof(SnapshotHeader) + SNAPSHOT_ALIGNMENT - 1) & ~uInt64(SNAPSHOT_ALIGNMENT - 1);
+		const uInt64 entriesBytes	= capacity * sizeof(EntryType);
+
+		Array<uInt8> buffer(static_cast<uSize>(entriesOffset + entriesBytes));
+
+		// Zero everything, including struct padding, so the checksum is stable
+		memset(buffer.Data(), 0, buffer.Size());
+
+		EntryType* pEntries = reinterpret_cast<EntryType*>(buffer.Data() + entriesOffset);
+
+		for (uInt64 i = 0; i < capacity; i++)
+		{
+			const typename TableType::EntryType& tableEntry = table.Data()[i];
+
+			if (!tableEntry.IsEmpty())
+			{
+				pEntries[i].hash	= tableEntry.hash;
+				pEntries[i].probe	= tableEntry.probe;
+				pEntries[i].used	= true;
+
+				fillEntry(pEntries[i], tableEntry.AsKeyValue());
+			}
+		}
+
+		SnapshotHeader header	= {};
+		header.magic			= SNAPSHOT_MAGIC;
+		header.version			= SNAPSHOT_VERSION;
+		header.hashSize			= sizeof(table.Data()->hash);
+		header.entrySize		= sizeof(EntryType);
+		header.keySize			= keySize;
+		header.valueSize		= valueSize;
+		header.size				= table.Size();
+		header.capacity			= capacity;
+		header.entriesOffset	= entriesOffset;
+		header.entriesBytes		= entriesBytes;
+		header.checksum			= SnapshotChecksum(pEntries, entriesBytes);
+		header.seed				= table.Seed();
+
+		memcpy(buffer.Data(), &header, sizeof(SnapshotHeader));
+
+		return buffer;
+	}
+
+	/* Writes a snapshot image of a Map */
+	template<typename KeyType, typename ValueType, typename HashType, typename PolicyType>
+	Array<uInt8> WriteSnapshot(const Map<KeyType, ValueType, HashType, PolicyType>& map)
+	{
+		static_assert(std::is_trivially_copyable<KeyType>::value && std::is_trivially_copyable<ValueType>::value,
+			"Map snapshots require trivially-copyable keys and values.");
+
+		using EntryType = SnapshotEntry<KeyType, ValueType, HashType>;
+
+		return _WriteSnapshot<EntryType>(map.GetTable(), sizeof(KeyType), sizeof(ValueType),
+			[](EntryType& entry, const MapPair<KeyType, ValueType>& pair)
+			{
+				entry.key	= pair.key;
+				entry.value	= pair.value;
+			});
+	}
+
+	/* Writes a snapshot image of a Set */
+	template<typename ValueType, typename HashType, typename PolicyType>
+	Array<uInt8> WriteSnapshot(const Set<ValueType, HashType, PolicyType>& set)
+	{
+		static_assert(std::is_trivially_copyable<ValueType>::value,
+			"Set snapshots require trivially-copyable values.");
+
+		using EntryType = SnapshotEntry<ValueType, void, HashType>;
+
+		return _WriteSnapshot<EntryType>(set.GetTable(), sizeof(ValueType), 0,
+			[](EntryType& entry, const ValueType& value)
+			{
+				entry.key = value;
+			});
+	}
+
+	/* Writes a snapshot of a Map or Set to a file */
+	template<typename ContainerType>
+	bool SaveSnapshot(const char* pPath, const ContainerType& container)
+	{
+		Array<uInt8> buffer = WriteSnapshot(container);
+
+		FILE* pFile = fopen(pPath, "wb");
+
+		if (!pFile)
+		{
+			return false;
+		}
+
+		const bool written = fwrite(buffer.Data(), 1, buffer.Size(), pFile) == buffer.Size();
+
+		return (fclose(pFile) == 0) && written;
+	}
+
+	template<typename _EntryType, typename HashType>
+	class _TableSnapshotBase
+	{
+	public:
+		using EntryType = _EntryType;
+
+	protected:
+		const SnapshotHeader*	mpHeader;
+		const EntryType*		mpEntries;
+
+	protected:
+		template<typename LookupType>
+		const EntryType* FindEntry(const LookupType& key) const
+		{
+			if (!mpEntries || mpHeader->capacity == 0)
+			{
+				return nullptr;
+			}
+
+			using KeyType = typename std::remove_cv<decltype(EntryType::key)>::type;
+
+			const auto& lookup		= LookupKey<KeyType>(key);
+			const HashType hash		= static_cast<HashType>(HashLookupSeeded<KeyType>(lookup, mpHeader->seed));
+			const uInt64 capacity	= mpHeader->capacity;
+
+			uInt64 index	= hash % capacity;
+			uInt64 dist		= 0;
+
+			// Bounded by capacity in case a corrupt image has no empty entry
+			while (dist < capacity)
+			{
+				const EntryType& entry = mpEntries[index];
+
+				if (!entry.used || dist > entry.probe)
+				{
+					return nullptr;
+				}
+
+				if (entry.hash == hash && entry.key == lookup)
+				{
+					return &entry;
+				}
+
+				index = (index + 1) % capacity;
+				++dist;
+			}
+
+			return nullptr;
+		}
+
+		bool OpenImpl(const void* pData, uSize sizeBytes, uInt32 keySize, uInt32 valueSize)
+		{
+			Close();
+
+			// The header and entries are read in place, so the image must be aligned for both
+			const std::uintptr_t address = reinterpret_cast<std::uintptr_t>(pData);
+
+			if (!pData || sizeBytes < sizeof(SnapshotHeader) ||
+				address % alignof(SnapshotHeader) != 0 ||
+				address % alignof(EntryType) != 0)
+			{
+				return false;
+			}
+
+			const SnapshotHeader* pHeader = static_cast<const SnapshotHeader*>(pData);
+
+			if (pHeader->magic != SNAPSHOT_MAGIC ||
+				pHeader->version != SNAPSHOT_VERSION ||
+				pHeader->hashSize != sizeof(HashType) ||
+				pHeader->entrySize != sizeof(EntryType) ||
+				pHeader->keySize != keySize ||
+				pHeader->valueSize != valueSize)
+			{
+				return false;
+			}
+
+			// Bounds are checked by division, so corrupt sizes cannot overflow into passing
+			if (pHeader->entriesOffset < sizeof(SnapshotHeader) ||
+				pHeader->entriesOffset > sizeBytes ||
+				pHeader->entriesOffset % alignof(EntryType) != 0 ||
+				pHeader->capacity > (sizeBytes - pHeader->entriesOffset) / sizeof(EntryType) ||
+				pHeader->entriesBytes != pHeader->capacity * sizeof(EntryType) ||
+				pHeader->size > pHeader->capacity)
+			{
+				return false;
+			}
+
+			mpHeader	= pHeader;
+			mpEntries	= reinterpret_cast<const EntryType*>(static_cast<const uInt8*>(pData) + pHeader->entriesOffset);
+
+			return true;
+		}
+
+	public:
+		_TableSnapshotBase()
+			: mpHeader(nullptr), mpEntries(nullptr) {}
+
+		/*
+			Validates the entry checksum. This reads every entry,
+			so it is kept separate from the constant-time Open().
+		*/
+		bool Verify() const
+		{
+			return mpHeader &&
+				SnapshotChecksum(mpEntries, mpHeader->entriesBytes) == mpHeader->checksum;
+		}
+
+		void Close()
+		{
+			mpHeader	= nullptr;
+			mpEntries	= nullptr;
+		}
+
+		uSize Size() const
+		{
+			return mpHeader ? static_cast<uSize>(mpHeader->size) : 0;
+		}
+
+		uSize Capacity() const
+		{
+			return mpHeader ? static_cast<uSize>(mpHeader->capacity) : 0;
+		}
+
+		bool IsEmpty() const
+		{
+			return Size() == 0;
+		}
+
+		bool IsOpen() const
+		{
+			return mpHeader != nullptr;
+		}
+	};
+
+	/*
+		A read-only view of a Map snapshot. The view does not own
+		the snapshot memory, which must outlive it.
+	*/
+	template<typename KeyType, typename ValueType, typename HashType = uSize>
+	class MapSnapshot : public _TableSnapshotBase<SnapshotEntry<KeyType, ValueType, HashType>, HashType>
+	{
+	public:
+		MapSnapshot() = default;
+
+		MapSnapshot(const void* pData, uSize sizeBytes)
+		{
+			Open(pData, sizeBytes);
+		}
+
+		/* Validates the header and binds the view, does not read entries */
+		bool Open(const void* pData, uSize sizeBytes)
+		{
+			return this->OpenImpl(pData, sizeBytes, sizeof(KeyType), sizeof(ValueType));
+		}
+
+		/* Returns a pointer to the value of key, or nullptr if not found */
+		template<typename LookupType>
+		const ValueType* Find(const LookupType& key) const
+		{
+			const auto* pEntry = this->FindEntry(key);
+			return pEntry ? &pEntry->value : nullptr;
+		}
+
+		template<typename LookupType>
+		bool Contains(const LookupType& key) const
+		{
+			return this->FindEntry(key) != nullptr;
+		}
+	};
+
+	/*
+		A read-only view of a Set snapshot. The view does not own
+		the snapshot memory, which must outlive it.
+	*/
+	template<typename ValueType, typename HashType = uSize>
+	class SetSnapshot : public _TableSnapshotBase<SnapshotEntry<ValueType, void, HashType>, HashType>
+	{
+	public:
+		SetSnapshot() = default;
+
+		SetSnapshot(const void* pData, uSize sizeBytes)
+		{
+			Open(pData, sizeBytes);
+		}
+
+		/* Validates the header and binds the view, does not read entries */
+		bool Open(const void* pData, uSize sizeBytes)
+		{
+			return this->OpenImpl(pData, sizeBytes, sizeof(ValueType), 0);
+		}
+
+		template<typename LookupType>
+		bool Contains(const LookupType& value) const
+		{
+			return this->FindEntry(value) != nullptr;
+		}
+	};
+}
\ No newline at end of file
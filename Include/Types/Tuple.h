@@ -2,6 +2,7 @@
 
 #include "Utility/Template.h"
 #include "Utility/Move.h"
+#include "Utility/Hash.h"
 
 namespace Quartz
 {
@@ -29,6 +30,11 @@ namespace Quartz
 		{
 			return value;
 		}
+
+		constexpr const Type& Value() const
+		{
+			return value;
+		}
 	};
 
 	/** Base class type for Tuple */
@@ -127,4 +133,45 @@ namespace Quartz
 			return sizeof...(Types) + 1;
 		}
 	};
+
+	/*
+		Hashes the tuple elements in order with HashCombine(). Elements are
+		hashed with HashSeeded(), so a seeded tuple hash is only as strong
+		as its elements' seeded hashes.
+	*/
+	template<sSize index, typename Type, typename... Types>
+	hash64 _HashTupleBase(const _TupleBase<index, Type, Types...>& base, hash64 hash, hash64 seed)
+	{
+		using ValueType = StripReference<Type>;
+
+		hash = HashCombine(hash,
+			HashSeeded<ValueType>(static_cast<const TupleValue<index, ValueType>&>(base).Value(), seed));
+
+		if constexpr (sizeof...(Types) > 0)
+		{
+			return _HashTupleBase(static_cast<const _TupleBase<index + 1, Types...>&>(base), hash, seed);
+		}
+		else
+		{
+			return hash;
+		}
+	}
+
+	template<typename Type, typename... Types>
+	struct Hasher<Tuple<Type, Types...>>
+	{
+		static hash64 HashValue(const Tuple<Type, Types...>& tuple)
+		{
+			return _HashTupleBase(static_cast<const _TupleBase<0, Type, Types...>&>(tuple), 0, 0);
+		}
+	};
+
+	template<typename Type, typename... Types>
+	struct SeededHasher<Tuple<Type, Types...>>
+	{
+		static hash64 HashValue(const Tuple<Type, Types...>& tuple, hash64 seed)
+		{
+			return _HashTupleBase(static_cast<const _TupleBase<0, Type, Types...>&>(tuple), seed, seed);
+		}
+	};
 }
\ No newline at end of file
@@ -1,10 +1,26 @@
 #pragma once
 
 #include "Types/Types.h"
+#include "Utility/Move.h"
+
+#include <cstring>
+#include <type_traits>
+#include <atomic>
+#include <chrono>
+#include <random>
+
+#if defined(_MSC_VER) && defined(_M_X64)
+#include <intrin.h>
+#endif
 
 #define QUARTZ_HASH_64
 #define QUARTZ_HASH_INVALID 0
 
+// Set to 1 to seed every new Table with ProcessHashSeed()
+#ifndef QUARTZ_HASH_SEEDED
+#define QUARTZ_HASH_SEEDED 0
+#endif
+
 namespace Quartz
 {
 	/*====================================================
@@ -13,8 +29,34 @@ namespace Quartz
 
 	using hash64 = uInt64;
 
+	template<typename Type>
+	struct _HashUnsupported
+	{
+		constexpr static bool value = false;
+	};
+
+	/*
+		Hashes whole families of types, such as pointers, enums and class
+		templates, that a single Hash<> specialization cannot cover.
+		Specialize Hasher with a static HashValue() function for a family
+		of types, or specialize Hash<> directly for a single type.
+	*/
+	template<typename Type, typename Enable = void>
+	struct Hasher
+	{
+		static_assert(_HashUnsupported<Type>::value, "No Hash<> specialization or Hasher exists for this type.");
+
+		static hash64 HashValue(const Type& value)
+		{
+			return QUARTZ_HASH_INVALID;
+		}
+	};
+
 	template<typename HashType>
-	hash64 Hash(const HashType& value) = delete;
+	hash64 Hash(const HashType& value)
+	{
+		return Hasher<HashType>::HashValue(value);
+	}
 
 	template<>
 	inline hash64 Hash<uInt32>(const uInt32& value)
@@ -37,7 +79,7 @@ namespace Quartz
 		value32 = ((value32 >> 16) ^ value32) * 0x45d9f3b;
 		value32 = ( value32 >> 16) ^ value32;
 
-		return value;
+		return value32;
 
 #endif // QUARTZ_64
 	}
@@ -61,4 +103,367 @@ namespace Quartz
 
 		return value64;
 	}
+
+	template<>
+	inline hash64 Hash<float>(const float& value)
+	{
+		// -0.0f == 0.0f, so both must hash the same
+		const float normal = value == 0.0f ? 0.0f : value;
+
+		uInt32 bits;
+		memcpy(&bits, &normal, sizeof(bits));
+
+		return Hash<uInt32>(bits);
+	}
+
+	template<>
+	inline hash64 Hash<double>(const double& value)
+	{
+		const double normal = value == 0.0 ? 0.0 : value;
+
+		uInt64 bits;
+		memcpy(&bits, &normal, sizeof(bits));
+
+		return Hash<uInt64>(bits);
+	}
+
+	/* All other integer types hash as their 64-bit value */
+	template<typename Type>
+	struct Hasher<Type, typename std::enable_if<std::is_integral<Type>::value>::type>
+	{
+		static hash64 HashValue(const Type& value)
+		{
+			return Hash<uInt64>(static_cast<uInt64>(value));
+		}
+	};
+
+	template<typename Type>
+	struct Hasher<Type, typename std::enable_if<std::is_enum<Type>::value>::type>
+	{
+		static hash64 HashValue(const Type& value)
+		{
+			return Hash<uInt64>(static_cast<uInt64>(value));
+		}
+	};
+
+	/*
+		Pointers hash by address. Character pointers are excluded, they
+		hash as strings through the Hash<const char*> and Hash<const wchar_t*>
+		specializations in String.h.
+	*/
+	template<typename Type>
+	struct Hasher<Type*>
+	{
+		static_assert(!std::is_same<typename std::remove_cv<Type>::type, char>::value &&
+			!std::is_same<typename std::remove_cv<Type>::type, wchar_t>::value,
+			"Character pointers hash as strings, include Types/String.h and use const char* or const wchar_t*.");
+
+		static hash64 HashValue(Type* const& value)
+		{
+			return Hash<uInt64>(static_cast<uInt64>(reinterpret_cast<uintptr_t>(value)));
+		}
+	};
+
+	//////////////////////////////////////////////////////////////
+
+	// wyhash (final v4) secrets, see https://github.com/wangyi-fudan/wyhash
+
+	constexpr uInt64 _HASH_SECRET0 = 0x2d358dccaa6c78a5ull;
+	constexpr uInt64 _HASH_SECRET1 = 0x8bb84b93962eacc9ull;
+	constexpr uInt64 _HASH_SECRET2 = 0x4b33a62ed433d4a3ull;
+	constexpr uInt64 _HASH_SECRET3 = 0x4d5a2da51de1aa47ull;
+
+	/* Multiplies a and b to 128 bits, storing the low half in a and the high half in b */
+	inline void _HashMul128(uInt64& a, uInt64& b)
+	{
+#if defined(__SIZEOF_INT128__)
+
+		const unsigned __int128 product = static_cast<unsigned __int128>(a) * b;
+
+		a = static_cast<uInt64>(product);
+		b = static_cast<uInt64>(product >> 64);
+
+#elif defined(_MSC_VER) && defined(_M_X64)
+
+		a = _umul128(a, b, &b);
+
+#else
+
+		const uInt64 aHigh = a >> 32, aLow = static_cast<uInt32>(a);
+		const uInt64 bHigh = b >> 32, bLow = static_cast<uInt32>(b);
+
+		const uInt64 highHigh	= aHigh * bHigh;
+		const uInt64 highLow	= aHigh * bLow;
+		const uInt64 lowHigh	= aLow * bHigh;
+		const uInt64 lowLow		= aLow * bLow;
+
+		const uInt64 middle = (lowLow >> 32) + static_cast<uInt32>(highLow) + static_cast<uInt32>(lowHigh);
+
+		a = (middle << 32) | static_cast<uInt32>(lowLow);
+		b = highHigh + (highLow >> 32) + (lowHigh >> 32) + (middle >> 32);
+
+#endif
+	}
+
+	/* Multiplies a and b to 128 bits and folds the halves with xor */
+	inline uInt64 _HashMum(uInt64 a, uInt64 b)
+	{
+		_HashMul128(a, b);
+		return a ^ b;
+	}
+
+	inline uInt64 _HashRead64(const uInt8* pBytes)
+	{
+		uInt64 value;
+		memcpy(&value, pBytes, sizeof(value));
+		return value;
+	}
+
+	inline uInt64 _HashRead32(const uInt8* pBytes)
+	{
+		uInt32 value;
+		memcpy(&value, pBytes, sizeof(value));
+		return value;
+	}
+
+	/*
+		Hashes size bytes of memory. Inputs over 48 bytes are consumed
+		by three independent multiply lanes per iteration, so long keys hash
+		at several bytes per cycle. Results depend on byte order and are not
+		stable across platforms.
+	*/
+	inline hash64 HashBytes(const void* pData, uSize size, uInt64 seed = 0)
+	{
+		const uInt8* pBytes = static_cast<const uInt8*>(pData);
+
+		uInt64 a;
+		uInt64 b;
+
+		seed ^= _HashMum(seed ^ _HASH_SECRET0, _HASH_SECRET1);
+
+		if (size <= 16)
+		{
+			if (size >= 4)
+			{
+				const uSize offset = (size >> 3) << 2;
+
+				a = (_HashRead32(pBytes) << 32) | _HashRead32(pBytes + offset);
+				b = (_HashRead32(pBytes + size - 4) << 32) | _HashRead32(pBytes + size - 4 - offset);
+			}
+			else if (size > 0)
+			{
+				a = (uInt64(pBytes[0]) << 16) | (uInt64(pBytes[size >> 1]) << 8) | pBytes[size - 1];
+				b = 0;
+			}
+			else
+			{
+				a = 0;
+				b = 0;
+			}
+		}
+		else
+		{
+			uSize remaining = size;
+
+			if (remaining > 48)
+			{
+				uInt64 lane1 = seed;
+				uInt64 lane2 = seed;
+
+				do
+				{
+					seed	= _HashMum(_HashRead64(pBytes)		^ _HASH_SECRET1, _HashRead64(pBytes + 8)	^ seed);
+					lane1	= _HashMum(_HashRead64(pBytes + 16)	^ _HASH_SECRET2, _HashRead64(pBytes + 24)	^ lane1);
+					lane2	= _HashMum(_HashRead64(pBytes + 32)	^ _HASH_SECRET3, _HashRead64(pBytes + 40)	^ lane2);
+
+					pBytes		+= 48;
+					remaining	-= 48;
+				}
+				while (remaining > 48);
+
+				seed ^= lane1 ^ lane2;
+			}
+
+			while (remaining > 16)
+			{
+				seed = _HashMum(_HashRead64(pBytes) ^ _HASH_SECRET1, _HashRead64(pBytes + 8) ^ seed);
+
+				pBytes		+= 16;
+				remaining	-= 16;
+			}
+
+			// The last 16 bytes, which may overlap bytes already consumed
+			a = _HashRead64(pBytes + remaining - 16);
+			b = _HashRead64(pBytes + remaining - 8);
+		}
+
+		a ^= _HASH_SECRET1;
+		b ^= seed;
+
+		_HashMul128(a, b);
+
+		return _HashMum(a ^ _HASH_SECRET0 ^ size, b ^ _HASH_SECRET1);
+	}
+
+	/*
+		Combines a hash into a running hash, for hashing composite keys.
+		The result depends on the order values are combined in.
+	*/
+	inline hash64 HashCombine(hash64 seed, hash64 value)
+	{
+		return _HashMum(seed ^ _HASH_SECRET0, value ^ _HASH_SECRET1);
+	}
+
+	/*
+		Hashes a value with a seed for HashSeeded(). By default the seed is
+		mixed into the value's Hash<>, which is enough for types whose Hash<>
+		is a bijection, such as integers. Types whose Hash<> can collide,
+		such as strings, must specialize SeededHasher to hash with the seed
+		from the start, or values that collide without a seed still collide.
+	*/
+	template<typename Type, typename Enable = void>
+	struct SeededHasher
+	{
+		static hash64 HashValue(const Type& value, hash64 seed)
+		{
+			return HashCombine(seed, Hash<Type>(value));
+		}
+	};
+
+	/*
+		Hashes a value with a secret seed, so hash values (and collisions)
+		cannot be predicted without knowing the seed. This guards tables
+		keyed by untrusted input against hash flooding. A seed of 0 hashes
+		identically to Hash<>().
+	*/
+	template<typename HashType>
+	hash64 HashSeeded(const HashType& value, hash64 seed)
+	{
+		return seed == 0 ? Hash<HashType>(value) : SeededHasher<HashType>::HashValue(value, seed);
+	}
+
+	/* Returns a new non-zero random seed for HashSeeded() */
+	inline hash64 RandomHashSeed()
+	{
+		static std::atomic<uInt64> counter(0);
+
+		std::random_device device;
+
+		const uInt64 entropy = (uInt64(device()) << 32) ^ device() ^
+			static_cast<uInt64>(std::chrono::high_resolution_clock::now().time_since_epoch().count());
+
+		const hash64 seed = HashCombine(entropy, counter.fetch_add(1, std::memory_order_relaxed));
+
+		return seed != 0 ? seed : _HASH_SECRET0;
+	}
+
+	/* Returns a random seed chosen once per process */
+	inline hash64 ProcessHashSeed()
+	{
+		static const hash64 seed = RandomHashSeed();
+		return seed;
+	}
+
+	/* Returns the seed new Tables start with, see QUARTZ_HASH_SEEDED */
+	inline hash64 DefaultHashSeed()
+	{
+#if QUARTZ_HASH_SEEDED
+		return ProcessHashSeed();
+#else
+		return 0;
+#endif
+	}
+
+	/*
+		Marks LookupType as usable in lookups of KeyType keys without
+		converting it to a KeyType (eg. const char* or WrapperString for
+		String keys). A transparent type must hash identically to the
+		KeyType it compares equal to. Other lookup types are converted to
+		KeyType first, so a Map<int64>::Find(1) hashes an int64 and a
+		Map<float>::Find(1) finds 1.0f. Types are compared after decay.
+	*/
+	template<typename KeyType, typename LookupType>
+	struct IsTransparentLookup
+	{
+		constexpr static bool value = std::is_same<KeyType, LookupType>::value;
+	};
+
+	template<typename KeyType, typename LookupType>
+	constexpr bool _IsTransparentLookup()
+	{
+		return IsTransparentLookup<typename std::decay<KeyType>::type, typename std::decay<LookupType>::type>::value;
+	}
+
+	/* The type a transparent lookup is hashed as, char arrays and char* hash as const char* */
+	template<typename LookupType, typename DecayType = typename std::decay<LookupType>::type>
+	using _LookupHashType = typename std::conditional<std::is_pointer<DecayType>::value,
+		const typename std::remove_pointer<DecayType>::type*, DecayType>::type;
+
+	/*
+		Returns a lookup key as used by Maps and Sets of KeyType: transparent
+		lookups are passed through, anything else is converted to KeyType.
+		Bind the result to a const auto& to keep a converted key alive.
+	*/
+	template<typename KeyType, typename LookupType>
+	inline decltype(auto) LookupKey(const LookupType& key)
+	{
+		if constexpr (_IsTransparentLookup<KeyType, LookupType>())
+		{
+			return (key);
+		}
+		else
+		{
+			return KeyType(key);
+		}
+	}
+
+	/*
+		Forwards a key passed to an inserting call on KeyType keys, such as
+		Map::Get. Transparent lookups are forwarded as they are, anything
+		else is converted to a KeyType temporary.
+	*/
+	template<typename KeyType, typename RKeyType>
+	inline decltype(auto) ForwardKey(RKeyType&& key)
+	{
+		if constexpr (_IsTransparentLookup<KeyType, RKeyType>())
+		{
+			return Forward<RKeyType>(key);
+		}
+		else
+		{
+			return KeyType(Forward<RKeyType>(key));
+		}
+	}
+
+	/*
+		Hashes a key used for lookups of KeyType keys, see LookupKey().
+		Character arrays (string literals) are hashed as pointers, allowing
+		lookups such as Map<String, T>::Find("key") without constructing a
+		String.
+	*/
+	template<typename KeyType, typename LookupType>
+	inline hash64 HashLookup(const LookupType& value)
+	{
+		if constexpr (_IsTransparentLookup<KeyType, LookupType>())
+		{
+			return Hash<_LookupHashType<LookupType>>(value);
+		}
+		else
+		{
+			return Hash<KeyType>(KeyType(value));
+		}
+	}
+
+	template<typename KeyType, typename LookupType>
+	inline hash64 HashLookupSeeded(const LookupType& value, hash64 seed)
+	{
+		if constexpr (_IsTransparentLookup<KeyType, LookupType>())
+		{
+			return HashSeeded<_LookupHashType<LookupType>>(value, seed);
+		}
+		else
+		{
+			return HashSeeded<KeyType>(KeyType(value), seed);
+		}
+	}
 }
\ No newline at end of file
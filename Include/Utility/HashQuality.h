@@ -0,0 +1,163 @@
+#pragma once
+
+#include "Hash.h"
+#include "Types/Array.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <type_traits>
+
+namespace Quartz
+{
+	/*====================================================
+	|               QUARTZLIB HASH QUALITY               |
+	=====================================================*/
+
+	/*
+		Statistical quality of a hash function over a sample of keys.
+
+		bucketChiSquare is the chi-square statistic of the keys binned by
+		hash % bucketCount, as a Table indexes them. bucketScore normalizes
+		it to standard deviations from a uniform distribution: a good hash
+		scores within about +-3, clustering hashes score far higher.
+
+		avalancheBias is the mean over all (input bit, output bit) pairs of
+		how far flipping the input bit is from flipping the output bit half
+		of the time, scaled from 0 (ideal) to 1 (the bit never or always
+		flips). worstAvalancheBias is the largest single pair. Avalanche is
+		only measured for trivially-copyable keys, and is -1 otherwise.
+
+		Note: Input bits that do not contribute to the key's value (padding)
+		always read as fully biased.
+	*/
+	struct HashQualityReport
+	{
+		uSize	keyCount;
+		uSize	bucketCount;
+		uSize	emptyBuckets;
+		uSize	maxBucketSize;
+		double	bucketChiSquare;
+		double	bucketScore;
+		uSize	hashCollisions;
+		double	avalancheBias;
+		double	worstAvalancheBias;
+	};
+
+	/*
+		Measures the bucket distribution, full hash collisions and avalanche
+		behaviour of hashFunc(const KeyType&) -> hash64 over pKeys.
+		A bucketCount of 0 uses one bucket per key.
+	*/
+	template<typename KeyType, typename HashFunc>
+	HashQualityReport AnalyzeHash(const KeyType* pKeys, uSize count, uSize bucketCount, HashFunc hashFunc)
+	{
+		HashQualityReport report = {};
+		report.keyCount				= count;
+		report.bucketCount			= bucketCount > 0 ? bucketCount : (count > 0 ? count : 1);
+		report.avalancheBias		= -1.0;
+		report.worstAvalancheBias	= -1.0;
+
+		if (count == 0)
+		{
+			return report;
+		}
+
+		Array<hash64> hashes(count);
+
+		for (uSize i = 0; i < count; i++)
+		{
+			hashes[i] = hashFunc(pKeys[i]);
+		}
+
+		// Bucket distribution
+
+		{
+			Array<uSize> buckets(report.bucketCount, 0);
+
+			for (uSize i = 0; i < count; i++)
+			{
+				++buckets[static_cast<uSize>(hashes[i] % report.bucketCount)];
+			}
+
+			const double expected = static_cast<double>(count) / report.bucketCount;
+
+			for (uSize i = 0; i < report.bucketCount; i++)
+			{
+				const double delta = buckets[i] - expected;
+				report.bucketChiSquare += delta * delta / expected;
+
+				report.emptyBuckets += buckets[i] == 0;
+				report.maxBucketSize = buckets[i] > report.maxBucketSize ? buckets[i] : report.maxBucketSize;
+			}
+
+			const double freedom = report.bucketCount > 1 ? static_cast<double>(report.bucketCount - 1) : 1.0;
+			report.bucketScore = (report.bucketChiSquare - freedom) / std::sqrt(2.0 * freedom);
+		}
+
+		// Full hash collisions between distinct keys
+
+		{
+			Array<hash64> sorted(hashes);
+			std::sort(sorted.Data(), sorted.Data() + count);
+
+			for (uSize i = 1; i < count; i++)
+			{
+				report.hashCollisions += sorted[i] == sorted[i - 1];
+			}
+		}
+
+		// Avalanche
+
+		if constexpr (std::is_trivially_copyable<KeyType>::value)
+		{
+			constexpr uSize inputBits	= sizeof(KeyType) * 8;
+			constexpr uSize outputBits	= sizeof(hash64) * 8;
+
+			Array<uInt32> flips(inputBits * outputBits, 0);
+
+			for (uSize i = 0; i < count; i++)
+			{
+				for (uSize inBit = 0; inBit < inputBits; inBit++)
+				{
+					uInt8 bytes[sizeof(KeyType)];
+					memcpy(bytes, &pKeys[i], sizeof(KeyType));
+					bytes[inBit / 8] ^= uInt8(1u << (inBit % 8));
+
+					KeyType flipped;
+					memcpy(&flipped, bytes, sizeof(KeyType));
+
+					const hash64 diff = hashes[i] ^ hashFunc(flipped);
+
+					for (uSize outBit = 0; outBit < outputBits; outBit++)
+					{
+						flips[inBit * outputBits + outBit] += (diff >> outBit) & 1;
+					}
+				}
+			}
+
+			double totalBias = 0.0;
+			double worstBias = 0.0;
+
+			for (uSize i = 0; i < inputBits * outputBits; i++)
+			{
+				const double bias = std::fabs(2.0 * flips[i] / count - 1.0);
+				totalBias += bias;
+				worstBias = bias > worstBias ? bias : worstBias;
+			}
+
+			report.avalancheBias		= totalBias / (inputBits * outputBits);
+			report.worstAvalancheBias	= worstBias;
+		}
+
+		return report;
+	}
+
+	/* Measures the quality of Hash<KeyType> over pKeys */
+	template<typename KeyType>
+	HashQualityReport AnalyzeHash(const KeyType* pKeys, uSize count, uSize bucketCount = 0)
+	{
+		return AnalyzeHash(pKeys, count, bucketCount,
+			[](const KeyType& key) -> hash64 { return Hash<KeyType>(key); });
+	}
+}
\ No newline at end of file
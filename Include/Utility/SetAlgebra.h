@@ -0,0 +1,351 @@
+#pragma once
+
+#include "Types/Types.h"
+#include "Types/Array.h"
+#include "Utility/Move.h"
+
+#include <type_traits>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define QUARTZ_SET_ALGEBRA_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace Quartz
+{
+	/*====================================================
+	|               QUARTZLIB SET ALGEBRA                |
+	=====================================================*/
+
+	/*
+		Set operations over arrays sorted in ascending order with no
+		duplicates. Output arrays are written in sorted order, and the raw
+		pointer versions return the number of values written. For set
+		operations between hash Sets, see Set::Union() etc.
+	*/
+
+	// Size ratio above which intersection gallops through the larger array
+	constexpr uSize SET_ALGEBRA_GALLOP_RATIO = 32;
+
+	/* Returns the index of the first value in [start, count) not less than value */
+	template<typename ValueType>
+	uSize _GallopLowerBound(const ValueType* pValues, uSize start, uSize count, const ValueType& value)
+	{
+		// Exponential search for a range containing value, then binary search it
+
+		uSize step	= 1;
+		uSize low	= start;
+		uSize high	= start;
+
+		while (high < count && pValues[high] < value)
+		{
+			low		= high + 1;
+			high	= start + step;
+			step	*= 2;
+		}
+
+		high = high < count ? high : count;
+
+		while (low < high)
+		{
+			const uSize mid = low + (high - low) / 2;
+
+			if (pValues[mid] < value)
+			{
+				low = mid + 1;
+			}
+			else
+			{
+				high = mid;
+			}
+		}
+
+		return low;
+	}
+
+	template<typename ValueType>
+	uSize _GallopIntersect(const ValueType* pSmall, uSize smallCount,
+		const ValueType* pLarge, uSize largeCount, ValueType* pOut)
+	{
+		uSize outCount	= 0;
+		uSize largeIdx	= 0;
+
+		for (uSize i = 0; i < smallCount && largeIdx < largeCount; i++)
+		{
+			largeIdx = _GallopLowerBound(pLarge, largeIdx, largeCount, pSmall[i]);
+
+			if (largeIdx < largeCount && !(pSmall[i] < pLarge[largeIdx]))
+			{
+				pOut[outCount++] = pSmall[i];
+			}
+		}
+
+		return outCount;
+	}
+
+	template<typename ValueType>
+	uSize _MergeIntersect(const ValueType* pA, uSize countA, uSize startA,
+		const ValueType* pB, uSize countB, uSize startB, ValueType* pOut, uSize outCount)
+	{
+		uSize a = startA;
+		uSize b = startB;
+
+		while (a < countA && b < countB)
+		{
+			if (pA[a] < pB[b])
+			{
+				a++;
+			}
+			else if (pB[b] < pA[a])
+			{
+				b++;
+			}
+			else
+			{
+				pOut[outCount++] = pA[a];
+				a++;
+				b++;
+			}
+		}
+
+		return outCount;
+	}
+
+#ifdef QUARTZ_SET_ALGEBRA_SSE2
+
+	/*
+		Intersects 32-bit values four at a time: each block of A is compared
+		against all four rotations of a block of B, and the block with the
+		smaller maximum is advanced.
+	*/
+	template<typename ValueType>
+	uSize _SimdIntersect32(const ValueType* pA, uSize countA, const ValueType* pB, uSize countB, ValueType* pOut)
+	{
+		uSize a = 0;
+		uSize b = 0;
+		uSize outCount = 0;
+
+		while (a + 4 <= countA && b + 4 <= countB)
+		{
+			const __m128i blockA = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pA + a));
+			const __m128i blockB = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pB + b));
+
+			__m128i match = _mm_cmpeq_epi32(blockA, blockB);
+			match = _mm_or_si128(match, _mm_cmpeq_epi32(blockA, _mm_shuffle_epi32(blockB, _MM_SHUFFLE(0, 3, 2, 1))));
+			match = _mm_or_si128(match, _mm_cmpeq_epi32(blockA, _mm_shuffle_epi32(blockB, _MM_SHUFFLE(1, 0, 3, 2))));
+			match = _mm_or_si128(match, _mm_cmpeq_epi32(blockA, _mm_shuffle_epi32(blockB, _MM_SHUFFLE(2, 1, 0, 3))));
+
+			int mask = _mm_movemask_ps(_mm_castsi128_ps(match));
+
+			while (mask)
+			{
+				const uSize lane = (mask & 1) ? 0 : (mask & 2) ? 1 : (mask & 4) ? 2 : 3;
+				pOut[outCount++] = pA[a + lane];
+				mask &= mask - 1;
+			}
+
+			const ValueType maxA = pA[a + 3];
+			const ValueType maxB = pB[b + 3];
+
+			a += (maxA < maxB || maxA == maxB) ? 4 : 0;
+			b += (maxB < maxA || maxA == maxB) ? 4 : 0;
+		}
+
+		return _MergeIntersect(pA, countA, a, pB, countB, b, pOut, outCount);
+	}
+
+#endif
+
+	/*
+		Writes the values in both A and B to pOut, which must hold the
+		smaller of countA and countB values. Gallops through the larger
+		array when the sizes are very uneven, and compares 32-bit integers
+		four at a time with SSE2 when available.
+	*/
+	template<typename ValueType>
+	uSize SortedIntersect(const ValueType* pA, uSize countA, const ValueType* pB, uSize countB, ValueType* pOut)
+	{
+		if (countA > countB * SET_ALGEBRA_GALLOP_RATIO)
+		{
+			return _GallopIntersect(pB, countB, pA, countA, pOut);
+		}
+
+		if (countB > countA * SET_ALGEBRA_GALLOP_RATIO)
+		{
+			return _GallopIntersect(pA, countA, pB, countB, pOut);
+		}
+
+#ifdef QUARTZ_SET_ALGEBRA_SSE2
+		if constexpr (std::is_integral<ValueType>::value && sizeof(ValueType) == 4)
+		{
+			return _SimdIntersect32(pA, countA, pB, countB, pOut);
+		}
+		else
+#endif
+		{
+			return _MergeIntersect(pA, countA, 0, pB, countB, 0, pOut, 0);
+		}
+	}
+
+	/* Writes the values in A or B to pOut, which must hold countA + countB values */
+	template<typename ValueType>
+	uSize SortedUnion(const ValueType* pA, uSize countA, const ValueType* pB, uSize countB, ValueType* pOut)
+	{
+		uSize a = 0;
+		uSize b = 0;
+		uSize outCount = 0;
+
+		while (a < countA && b < countB)
+		{
+			if (pA[a] < pB[b])
+			{
+				pOut[outCount++] = pA[a++];
+			}
+			else if (pB[b] < pA[a])
+			{
+				pOut[outCount++] = pB[b++];
+			}
+			else
+			{
+				pOut[outCount++] = pA[a++];
+				b++;
+			}
+		}
+
+		while (a < countA)
+		{
+			pOut[outCount++] = pA[a++];
+		}
+
+		while (b < countB)
+		{
+			pOut[outCount++] = pB[b++];
+		}
+
+		return outCount;
+	}
+
+	/* Writes the values in A that are not in B to pOut, which must hold countA values */
+	template<typename ValueType>
+	uSize SortedDifference(const ValueType* pA, uSize countA, const ValueType* pB, uSize countB, ValueType* pOut)
+	{
+		uSize b = 0;
+		uSize outCount = 0;
+
+		const bool gallop = countB > countA * SET_ALGEBRA_GALLOP_RATIO;
+
+		for (uSize a = 0; a < countA; a++)
+		{
+			if (gallop)
+			{
+				b = _GallopLowerBound(pB, b, countB, pA[a]);
+			}
+			else
+			{
+				while (b < countB && pB[b] < pA[a])
+				{
+					b++;
+				}
+			}
+
+			if (b == countB || pA[a] < pB[b])
+			{
+				pOut[outCount++] = pA[a];
+			}
+		}
+
+		return outCount;
+	}
+
+	/* Returns true if every value of A is in B */
+	template<typename ValueType>
+	bool SortedIsSubset(const ValueType* pA, uSize countA, const ValueType* pB, uSize countB)
+	{
+		if (countA > countB)
+		{
+			return false;
+		}
+
+		uSize b = 0;
+
+		const bool gallop = countB > countA * SET_ALGEBRA_GALLOP_RATIO;
+
+		for (uSize a = 0; a < countA; a++)
+		{
+			if (gallop)
+			{
+				b = _GallopLowerBound(pB, b, countB, pA[a]);
+			}
+			else
+			{
+				while (b < countB && pB[b] < pA[a])
+				{
+					b++;
+				}
+			}
+
+			if (b == countB || pA[a] < pB[b])
+			{
+				return false;
+			}
+
+			b++;
+		}
+
+		return true;
+	}
+
+	/* Moves the first count values of buffer into a tightly sized Array */
+	template<typename ValueType>
+	Array<ValueType> _SetAlgebraResult(Array<ValueType>& buffer, uSize count)
+	{
+		Array<ValueType> result;
+
+		if (count > 0)
+		{
+			result.Reserve(count);
+		}
+
+		for (uSize i = 0; i < count; i++)
+		{
+			result.PushBack(Move(buffer[i]));
+		}
+
+		return result;
+	}
+
+	template<typename ValueType>
+	Array<ValueType> SortedIntersect(const Array<ValueType>& arrayA, const Array<ValueType>& arrayB)
+	{
+		const uSize maxCount = arrayA.Size() < arrayB.Size() ? arrayA.Size() : arrayB.Size();
+
+		Array<ValueType> result(maxCount);
+		const uSize count = SortedIntersect(arrayA.Data(), arrayA.Size(), arrayB.Data(), arrayB.Size(), result.Data());
+
+		return _SetAlgebraResult(result, count);
+	}
+
+	template<typename ValueType>
+	Array<ValueType> SortedUnion(const Array<ValueType>& arrayA, const Array<ValueType>& arrayB)
+	{
+		Array<ValueType> result(arrayA.Size() + arrayB.Size());
+		const uSize count = SortedUnion(arrayA.Data(), arrayA.Size(), arrayB.Data(), arrayB.Size(), result.Data());
+
+		return _SetAlgebraResult(result, count);
+	}
+
+	template<typename ValueType>
+	Array<ValueType> SortedDifference(const Array<ValueType>& arrayA, const Array<ValueType>& arrayB)
+	{
+		Array<ValueType> result(arrayA.Size());
+		const uSize count = SortedDifference(arrayA.Data(), arrayA.Size(), arrayB.Data(), arrayB.Size(), result.Data());
+
+		return _SetAlgebraResult(result, count);
+	}
+
+	template<typename ValueType>
+	bool SortedIsSubset(const Array<ValueType>& arrayA, const Array<ValueType>& arrayB)
+	{
+		return SortedIsSubset(arrayA.Data(), arrayA.Size(), arrayB.Data(), arrayB.Size());
+	}
+}
\ No newline at end of file
@@ -0,0 +1,212 @@
+#pragma once
+
+#include "Types/Types.h"
+#include <atomic>
+#include <thread>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <immintrin.h>
+#endif
+
+namespace Quartz
+{
+	/*====================================================
+	|                QUARTZLIB SPIN LOCK                 |
+	=====================================================*/
+
+	// Hints the cpu that the calling thread is spin-waiting
+	inline void CpuPause()
+	{
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+		_mm_pause();
+#elif defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+		__builtin_ia32_pause();
+#elif defined(__GNUC__) && defined(__aarch64__)
+		asm volatile("yield");
+#endif
+	}
+
+	/*
+		Spin-wait backoff. Pauses for the first SPIN_LIMIT waits, then
+		yields the thread so an oversubscribed lock holder can progress.
+	*/
+	class SpinWait
+	{
+	private:
+		constexpr static uInt32 SPIN_LIMIT = 64;
+
+		uInt32 mCount;
+
+	public:
+		SpinWait()
+			: mCount(0) {}
+
+		void Wait()
+		{
+			if (mCount < SPIN_LIMIT)
+			{
+				CpuPause();
+				mCount++;
+			}
+			else
+			{
+				std::this_thread::yield();
+			}
+		}
+	};
+
+	/* A simple test-and-test-and-set spin lock */
+	class SpinLock
+	{
+	private:
+		std::atomic<bool> mLocked;
+
+	public:
+		SpinLock()
+			: mLocked(false) {}
+
+		SpinLock(const SpinLock&) = delete;
+		SpinLock& operator=(const SpinLock&) = delete;
+
+		void Lock()
+		{
+			SpinWait spin;
+
+			while (mLocked.exchange(true, std::memory_order_acquire))
+			{
+				while (mLocked.load(std::memory_order_relaxed))
+				{
+					spin.Wait();
+				}
+			}
+		}
+
+		bool TryLock()
+		{
+			return !mLocked.load(std::memory_order_relaxed) &&
+				!mLocked.exchange(true, std::memory_order_acquire);
+		}
+
+		void Unlock()
+		{
+			mLocked.store(false, std::memory_order_release);
+		}
+	};
+
+	/*
+		A writer-preferring reader/writer spin lock.
+		Any number of readers may hold the lock at once, a writer
+		waits for active readers to leave and blocks new readers.
+	*/
+	class SharedSpinLock
+	{
+	private:
+		constexpr static uInt32 WRITER_BIT = 0x80000000u;
+
+		std::atomic<uInt32> mState;
+
+	public:
+		SharedSpinLock()
+			: mState(0) {}
+
+		SharedSpinLock(const SharedSpinLock&) = delete;
+		SharedSpinLock& operator=(const SharedSpinLock&) = delete;
+
+		void Lock()
+		{
+			SpinWait spin;
+
+			// Claim the writer bit, blocking new readers
+			while (mState.fetch_or(WRITER_BIT, std::memory_order_acquire) & WRITER_BIT)
+			{
+				while (mState.load(std::memory_order_relaxed) & WRITER_BIT)
+				{
+					spin.Wait();
+				}
+			}
+
+			// Wait for active readers to leave
+			while (mState.load(std::memory_order_acquire) != WRITER_BIT)
+			{
+				spin.Wait();
+			}
+		}
+
+		void Unlock()
+		{
+			mState.fetch_and(~WRITER_BIT, std::memory_order_release);
+		}
+
+		void LockShared()
+		{
+			SpinWait spin;
+
+			while (true)
+			{
+				while (mState.load(std::memory_order_relaxed) & WRITER_BIT)
+				{
+					spin.Wait();
+				}
+
+				if (!(mState.fetch_add(1, std::memory_order_acquire) & WRITER_BIT))
+				{
+					return;
+				}
+
+				// A writer got in first, back off
+				mState.fetch_sub(1, std::memory_order_relaxed);
+			}
+		}
+
+		void UnlockShared()
+		{
+			mState.fetch_sub(1, std::memory_order_release);
+		}
+	};
+
+	/* Holds a lock for the lifetime of the guard */
+	template<typename LockType>
+	class LockGuard
+	{
+	private:
+		LockType& mLock;
+
+	public:
+		LockGuard(LockType& lock)
+			: mLock(lock)
+		{
+			mLock.Lock();
+		}
+
+		~LockGuard()
+		{
+			mLock.Unlock();
+		}
+
+		LockGuard(const LockGuard&) = delete;
+		LockGuard& operator=(const LockGuard&) = delete;
+	};
+
+	/* Holds a shared lock for the lifetime of the guard */
+	template<typename LockType>
+	class SharedLockGuard
+	{
+	private:
+		LockType& mLock;
+
+	public:
+		SharedLockGuard(LockType& lock)
+			: mLock(lock)
+		{
+			mLock.LockShared();
+		}
+
+		~SharedLockGuard()
+		{
+			mLock.UnlockShared();
+		}
+
+		SharedLockGuard(const SharedLockGuard&) = delete;
+		SharedLockGuard& operator=(const SharedLockGuard&) = delete;
+	};
+}
\ No newline at end of file
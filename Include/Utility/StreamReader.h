@@ -0,0 +1,391 @@
+#pragma once
+
+#include "Types/String.h"
+#include "Memory/MappedFile.h"
+#include "Memory/Memory.h"
+#include "Utility/NumberFormat.h"
+#include "Utility/Move.h"
+#include "Utility/StringSearch.h"
+#include "Utility/Swap.h"
+#include "Utility/Whitespace.h"
+
+namespace Quartz
+{
+	/*====================================================
+	|               QUARTZLIB STREAM READER              |
+	=====================================================*/
+
+	/*
+		Reads text by cursor from memory, a memory-mapped file or a chunked
+		stream, without holding the input as one String.
+
+		The reader sees a window of the input. Over memory or a mapped file
+		the window is the whole input. Over a stream, the window is a buffer
+		the refill function fills a chunk at a time. When a read reaches the
+		end of the window, the unread tail is moved to the front of the
+		buffer and the rest is refilled. The buffer doubles if one piece is
+		longer than the whole buffer.
+
+		Reads return views into the window instead of Substrings, so nothing
+		is allocated or refcounted per read. A view is valid until the next
+		read. Over a stream, copy it to a String to keep it longer.
+	*/
+	template<typename CharType>
+	class StreamReaderBase
+	{
+	public:
+		using WrapperStringType = WrapperStringBase<CharType>;
+
+		/*
+			Writes up to capacity characters to pBuffer and returns how many
+			were written. Returns 0 at the end of the stream.
+		*/
+		using RefillFunc = uSize(*)(void* pUser, CharType* pBuffer, uSize capacity);
+
+		constexpr static uSize DEFAULT_CHUNK_SIZE = 64 * 1024;
+
+	private:
+		// Characters kept past a number, so it is not cut off at the end of the window
+		constexpr static uSize NUMBER_LOOKAHEAD = 32;
+
+		const CharType*	mpData;
+		uSize			mLength;
+		uSize			mCursor;
+		uSize			mOffset;
+
+		CharType*		mpBuffer;
+		uSize			mCapacity;
+		RefillFunc		mRefill;
+		void*			mpUser;
+
+		MappedFile		mFile;
+
+	private:
+		friend void Swap(StreamReaderBase& reader1, StreamReaderBase& reader2)
+		{
+			using Quartz::Swap;
+
+			Swap(reader1.mpData, reader2.mpData);
+			Swap(reader1.mLength, reader2.mLength);
+			Swap(reader1.mCursor, reader2.mCursor);
+			Swap(reader1.mOffset, reader2.mOffset);
+			Swap(reader1.mpBuffer, reader2.mpBuffer);
+			Swap(reader1.mCapacity, reader2.mCapacity);
+			Swap(reader1.mRefill, reader2.mRefill);
+			Swap(reader1.mpUser, reader2.mpUser);
+			Swap(reader1.mFile, reader2.mFile);
+		}
+
+		uSize Available() const
+		{
+			return mLength - mCursor;
+		}
+
+		/*
+			Moves the unread tail to the front of the buffer and reads more
+			after it. Returns false if there is no more input.
+		*/
+		bool Refill()
+		{
+			if (!mRefill)
+			{
+				return false;
+			}
+
+			const uSize tail = Available();
+
+			if (tail == mCapacity)
+			{
+				CharType* pBuffer = new CharType[mCapacity * 2];
+				MemCopy(pBuffer, mpBuffer + mCursor, tail * sizeof(CharType));
+				delete[] mpBuffer;
+
+				mpBuffer	= pBuffer;
+				mCapacity	*= 2;
+			}
+			else if (mCursor > 0)
+			{
+				MemMove(mpBuffer, mpBuffer + mCursor, tail * sizeof(CharType));
+			}
+
+			mOffset		+= mCursor;
+			mCursor		= 0;
+			mLength		= tail;
+			mpData		= mpBuffer;
+
+			const uSize count = mRefill(mpUser, mpBuffer + tail, mCapacity - tail);
+
+			if (count == 0)
+			{
+				// Stop asking once the stream has ended
+				mRefill = nullptr;
+				return false;
+			}
+
+			mLength += count;
+
+			return true;
+		}
+
+		/* Refills until count characters are available or the input ends, returns the available count */
+		uSize Ensure(uSize count)
+		{
+			while (Available() < count && Refill()) {}
+
+			return Available();
+		}
+
+		static uSize ParseNumber(const CharType* pStr, uSize length, int64& outValue)
+		{
+			return ParseInt(pStr, length, outValue);
+		}
+
+		static uSize ParseNumber(const CharType* pStr, uSize length, float& outValue)
+		{
+			return ParseFloat(pStr, length, outValue);
+		}
+
+		static uSize ParseNumber(const CharType* pStr, uSize length, double& outValue)
+		{
+			return ParseFloat(pStr, length, outValue);
+		}
+
+		/* Parses a number at the cursor, refilling while it may continue past the window */
+		template<typename ValueType>
+		bool ReadNumber(ValueType& outValue)
+		{
+			SkipWhitespace();
+
+			uSize available = Ensure(NUMBER_LOOKAHEAD);
+			uSize count = ParseNumber(mpData + mCursor, available, outValue);
+
+			// A number ending near the end of the window may continue past it
+			while (mRefill && count + NUMBER_LOOKAHEAD > available)
+			{
+				available = Ensure(count + 2 * NUMBER_LOOKAHEAD);
+				count = ParseNumber(mpData + mCursor, available, outValue);
+			}
+
+			mCursor += count;
+
+			return count != 0;
+		}
+
+		/* Finds the next delim from the cursor, refilling as needed. Returns its index from the cursor, or the available count */
+		uSize FindNext(const WrapperStringType& delim)
+		{
+			// An empty delim matches at the cursor
+			if (delim.Length() == 0)
+			{
+				return 0;
+			}
+
+			uSize searched = 0;
+
+			while (true)
+			{
+				const CharType* pStart = mpData + mCursor;
+				const uSize available = Available();
+
+				// Resume where the last search could not have matched
+				const uSize from = searched >= delim.Length() ? searched - delim.Length() + 1 : 0;
+				const CharType* pFound = StrFind(pStart + from, available - from, delim.Str(), delim.Length());
+
+				if (pFound)
+				{
+					return static_cast<uSize>(pFound - pStart);
+				}
+
+				searched = available;
+
+				if (!Refill())
+				{
+					return Available();
+				}
+			}
+		}
+
+	public:
+		StreamReaderBase()
+			: mpData(nullptr), mLength(0), mCursor(0), mOffset(0),
+			mpBuffer(nullptr), mCapacity(0), mRefill(nullptr), mpUser(nullptr) {}
+
+		/* Reads length characters in memory, which must outlive the reader */
+		StreamReaderBase(const CharType* pData, uSize length)
+			: StreamReaderBase()
+		{
+			mpData	= pData;
+			mLength	= length;
+		}
+
+		/* Reads a String, which must outlive the reader */
+		explicit StreamReaderBase(const WrapperStringType& str)
+			: StreamReaderBase(str.Str(), str.Length()) {}
+
+		/* Reads a memory-mapped file, taking ownership of it */
+		explicit StreamReaderBase(MappedFile&& file)
+			: StreamReaderBase()
+		{
+			Swap(mFile, file);
+
+			mpData	= static_cast<const CharType*>(mFile.Data());
+			mLength	= mFile.Size() / sizeof(CharType);
+		}
+
+		/* Reads a stream refilled chunkSize characters at a time by refill(pUser, ...) */
+		StreamReaderBase(RefillFunc refill, void* pUser, uSize chunkSize = DEFAULT_CHUNK_SIZE)
+			: StreamReaderBase()
+		{
+			mCapacity	= chunkSize > 2 * NUMBER_LOOKAHEAD ? chunkSize : 2 * NUMBER_LOOKAHEAD;
+			mpBuffer	= new CharType[mCapacity];
+			mpData		= mpBuffer;
+			mRefill		= refill;
+			mpUser		= pUser;
+		}
+
+		StreamReaderBase(const StreamReaderBase&) = delete;
+
+		StreamReaderBase(StreamReaderBase&& reader) noexcept
+			: StreamReaderBase()
+		{
+			Swap(*this, reader);
+		}
+
+		~StreamReaderBase()
+		{
+			delete[] mpBuffer;
+		}
+
+		StreamReaderBase& operator=(StreamReaderBase reader)
+		{
+			Swap(*this, reader);
+			return *this;
+		}
+
+		/* Opens and maps the file at pPath, returns false if it could not be mapped */
+		bool Open(const char* pPath)
+		{
+			MappedFile file;
+
+			if (!file.Open(pPath))
+			{
+				return false;
+			}
+
+			*this = StreamReaderBase(Move(file));
+
+			return true;
+		}
+
+		/* Returns the next character without reading it, or 0 at the end */
+		CharType Peek()
+		{
+			return Ensure(1) ? mpData[mCursor] : CharType(0);
+		}
+
+		/* Reads the next character, or returns 0 at the end */
+		CharType Read()
+		{
+			return Ensure(1) ? mpData[mCursor++] : CharType(0);
+		}
+
+		/* Reads up to the next delim and skips it, or reads the rest if there is none */
+		WrapperStringType ReadThrough(const WrapperStringType& delim)
+		{
+			const uSize count = FindNext(delim);
+			const WrapperStringType piece(mpData + mCursor, count);
+
+			mCursor += count < Available() ? count + delim.Length() : count;
+
+			return piece;
+		}
+
+		/* Reads up to the next delim, leaving it unread */
+		WrapperStringType ReadTo(const WrapperStringType& delim)
+		{
+			const uSize count = FindNext(delim);
+			const WrapperStringType piece(mpData + mCursor, count);
+
+			mCursor += count;
+
+			return piece;
+		}
+
+		/* Reads the next line, without its \n or \r\n terminator */
+		WrapperStringType ReadLine()
+		{
+			static const CharType newline[] = { '\n' };
+
+			const WrapperStringType line = ReadThrough(WrapperStringType(newline, 1));
+
+			if (line.Length() > 0 && line.Str()[line.Length() - 1] == CharType('\r'))
+			{
+				return WrapperStringType(line.Str(), line.Length() - 1);
+			}
+
+			return line;
+		}
+
+		void SkipWhitespace()
+		{
+			while (Ensure(1) && IsWhitespace(mpData[mCursor]))
+			{
+				mCursor++;
+			}
+		}
+
+		/* Reads an integer after any whitespace, returns false if there is none */
+		bool ReadInt(int64& outValue)
+		{
+			return ReadNumber(outValue);
+		}
+
+		bool ReadFloat(float& outValue)
+		{
+			return ReadNumber(outValue);
+		}
+
+		bool ReadDouble(double& outValue)
+		{
+			return ReadNumber(outValue);
+		}
+
+		int64 ReadInt()
+		{
+			int64 value = 0;
+			ReadInt(value);
+			return value;
+		}
+
+		float ReadFloat()
+		{
+			float value = 0.0f;
+			ReadFloat(value);
+			return value;
+		}
+
+		double ReadDouble()
+		{
+			double value = 0.0;
+			ReadDouble(value);
+			return value;
+		}
+
+		/* Returns true once all input has been read, refilling to check */
+		bool IsEnd()
+		{
+			return Ensure(1) == 0;
+		}
+
+		/* Returns the number of characters read since the start of the input */
+		uSize GetOffset() const
+		{
+			return mOffset + mCursor;
+		}
+	};
+
+	using StreamReaderA	= StreamReaderBase<char>;
+	using StreamReaderW	= StreamReaderBase<wchar_t>;
+
+	using StreamReader	= StreamReaderA;
+}
\ No newline at end of file
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Types/String.h"
+#include "Utility/NumberFormat.h"
 #include <string.h>
 
 namespace Quartz
@@ -9,36 +10,53 @@ namespace Quartz
 	|                   STRING READER                    |
 	=====================================================*/
 
+	/*
+		Reads a number from a null-terminated string after any leading
+		whitespace, like strtof and strtol. ppEnd is set past the number,
+		or to pStr if none was read.
+	*/
 	template<typename CharType>
-	float ReadFloat(const CharType* pStr, CharType** ppEnd) = delete;
-
-	template<>
-	inline float ReadFloat<char>(const char* pStr, char** ppEnd)
+	float ReadFloat(const CharType* pStr, CharType** ppEnd)
 	{
-		return strtof(pStr, ppEnd);
-	}
+		const CharType* pNumber = pStr;
 
-	template<>
-	inline float ReadFloat<wchar_t>(const wchar_t* pStr, wchar_t** ppEnd)
-	{
-		return wcstof(pStr, ppEnd);
-	}
+		while (IsWhitespace(*pNumber))
+		{
+			pNumber++;
+		}
 
-	template<typename CharType>
-	int64 ReadInt(const CharType* pStr, CharType** ppEnd) = delete;
+		// The terminator stops the parse, so the length can be left unbounded
+		float value = 0.0f;
+		const uSize count = ParseFloat(pNumber, ~uSize(0), value);
 
-	template<>
-	inline int64 ReadInt<char>(const char* pStr, char** ppEnd)
-	{
-		return strtol(pStr, ppEnd, 0);
+		*ppEnd = const_cast<CharType*>(count ? pNumber + count : pStr);
+
+		return value;
 	}
 
-	template<>
-	inline int64 ReadInt<wchar_t>(const wchar_t* pStr, wchar_t** ppEnd)
+	template<typename CharType>
+	int64 ReadInt(const CharType* pStr, CharType** ppEnd)
 	{
-		return wcstol(pStr, ppEnd, 0);
+		const CharType* pNumber = pStr;
+
+		while (IsWhitespace(*pNumber))
+		{
+			pNumber++;
+		}
+
+		int64 value = 0;
+		const uSize count = ParseInt(pNumber, ~uSize(0), value);
+
+		*ppEnd = const_cast<CharType*>(count ? pNumber + count : pStr);
+
+		return value;
 	}
 
+	/*
+		Reads through a String by cursor. Pieces are sliced from the string
+		only when returned, so reads do not allocate or refcount. See
+		StreamReaderBase for input that is not in memory as one String.
+	*/
 	template<typename StringType>
 	class StringReaderBase
 	{
@@ -49,12 +67,20 @@ namespace Quartz
 
 	private:
 		StringType		mString;
-		SubstringType	mRemaining;
 		uSize			mCursor;
 
+		/* Returns the index of the next delim from the cursor, or the string length */
+		uSize FindNext(const WrapperType& delim) const
+		{
+			const CharType* pStr = mString.Str();
+			const CharType* pFound = StrFind(pStr + mCursor, mString.Length() - mCursor, delim.Str(), delim.Length());
+
+			return pFound ? static_cast<uSize>(pFound - pStr) : mString.Length();
+		}
+
 	public:
 		StringReaderBase(const StringType& string) :
-			mString(string), mCursor(0), mRemaining(string.Substring(0)) { }
+			mString(string), mCursor(0) { }
 
 		const CharType& Peek()
 		{
@@ -68,21 +94,19 @@ namespace Quartz
 				return mString.Str()[mString.Length()];
 			}
 
-			const CharType& readChar = mString.Str()[mCursor++];
-			mRemaining = mString.Substring(mCursor);
-			return readChar;
+			return mString.Str()[mCursor++];
 		}
 
+		/* Reads up to the next delim and skips it, or reads the rest if there is none */
 		SubstringType ReadThrough(const WrapperType& delim)
 		{
 			if (IsEmpty())
 			{
-				return Substring();
+				return SubstringType();
 			}
 
-			// @TODO: check this isn't a problem .Str()
-			uSize nextIdx = mCursor + mRemaining.Find(delim.Str()); 
-			Substring line = mString.Substring(mCursor, nextIdx);
+			const uSize nextIdx = FindNext(delim);
+			SubstringType line = mString.Substring(mCursor, nextIdx);
 			mCursor = nextIdx + delim.Length();
 
 			if (mCursor > mString.Length())
@@ -90,38 +114,31 @@ namespace Quartz
 				mCursor = mString.Length();
 			}
 
-			mRemaining = mString.Substring(mCursor);
-
 			return line;
 		}
 
+		/* Reads up to the next delim, leaving it unread */
 		SubstringType ReadTo(const WrapperType& delim)
 		{
 			if (IsEmpty())
 			{
-				return Substring();
+				return SubstringType();
 			}
 
-			// @TODO: check this isn't a problem .Str()
-			uSize nextIdx = mCursor + mRemaining.Find(delim.Str());
-			Substring line = mString.Substring(mCursor, nextIdx);
+			const uSize nextIdx = FindNext(delim);
+			SubstringType line = mString.Substring(mCursor, nextIdx);
 			mCursor = nextIdx;
 
-			if (mCursor > mString.Length())
-			{
-				mCursor = mString.Length();
-			}
-
-			mRemaining = mString.Substring(mCursor);
-
 			return line;
 		}
 
 		SubstringType ReadLine()
 		{
-			SubstringType line = ReadThrough("\n");
+			static const CharType newline[] = { '\n' };
+
+			SubstringType line = ReadThrough(WrapperType(newline, 1));
 
-			if (!line.IsEmpty() && line.Str()[line.Length() - 1] == '\r')
+			if (!line.IsEmpty() && line.Str()[line.Length() - 1] == CharType('\r'))
 			{
 				return line.Substring(0, line.Length() - 1);
 			}
@@ -131,33 +148,30 @@ namespace Quartz
 
 		void SkipWhitespace()
 		{
-			const CharType* pStr = &(mString.Str()[mCursor]);
+			const CharType* pStr = mString.Str();
 
-			while (IsWhitespace(*pStr))
+			while (mCursor < mString.Length() && IsWhitespace(pStr[mCursor]))
 			{
-				pStr++;
 				mCursor++;
 			}
-
-			mRemaining = mString.Substring(mCursor);
 		}
 
 		float ReadFloat()
 		{
-			CharType* pRead = nullptr;
-			const CharType* pStr = &(mString.Str()[mCursor]);
-			float value = Quartz::ReadFloat<CharType>(pStr, &pRead);
-			SetCursor(pRead - mString.Str());
+			SkipWhitespace();
+
+			float value = 0.0f;
+			mCursor += ParseFloat(mString.Str() + mCursor, mString.Length() - mCursor, value);
 
 			return value;
 		}
 
 		int64 ReadInt()
 		{
-			CharType* pRead = nullptr;
-			const CharType* pStr = &(mString.Str()[mCursor]);
-			int64 value = Quartz::ReadInt<CharType>(pStr, &pRead);
-			SetCursor(pRead - mString.Str());
+			SkipWhitespace();
+
+			int64 value = 0;
+			mCursor += ParseInt(mString.Str() + mCursor, mString.Length() - mCursor, value);
 
 			return value;
 		}
@@ -175,14 +189,13 @@ namespace Quartz
 			}
 
 			mCursor = index;
-			mRemaining = mString.Substring(mCursor);
 
 			return true;
 		}
 
 		bool IsEmpty() const { return mCursor >= mString.Length(); }
 		bool IsEnd() const { return IsEmpty(); }
-		const SubstringType& GetRemaining() const { return mRemaining; }
+		SubstringType GetRemaining() const { return mString.Substring(mCursor); }
 		uSize GetCursor() const { return mCursor; }
 	};
 
@@ -0,0 +1,771 @@
+#pragma once
+
+#include "Types/Types.h"
+
+#include <cstring>
+#include <cwchar>
+#include <cstdint>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define QUARTZ_STRING_SSE2
+#include <emmintrin.h>
+#endif
+
+#if defined(__AVX2__)
+#define QUARTZ_STRING_AVX2
+#include <immintrin.h>
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+// Null-terminated scans read whole aligned blocks, which may start before the string
+#if defined(__clang__) || defined(__GNUC__)
+#define QUARTZ_STRING_NO_SANITIZE __attribute__((no_sanitize("address")))
+#else
+#define QUARTZ_STRING_NO_SANITIZE
+#endif
+
+namespace Quartz
+{
+	/*====================================================
+	|              QUARTZLIB STRING SEARCH               |
+	=====================================================*/
+
+	/*
+		Length-bounded character and substring search for char and wchar_t.
+		None of these functions stop at, or require, a null terminator, so
+		they can search Substrings in place. Substring search filters
+		candidate positions a vector at a time by comparing both the first
+		and the last character of the needle (AVX2 when compiled for it,
+		otherwise SSE2), and only compares the rest of the needle at
+		positions where both match.
+	*/
+
+	inline uInt32 _StrLowestBit(uInt32 mask)
+	{
+#if defined(_MSC_VER)
+		unsigned long index;
+		_BitScanForward(&index, mask);
+		return static_cast<uInt32>(index);
+#else
+		return static_cast<uInt32>(__builtin_ctz(mask));
+#endif
+	}
+
+	inline uInt32 _StrHighestBit(uInt32 mask)
+	{
+#if defined(_MSC_VER)
+		unsigned long index;
+		_BitScanReverse(&index, mask);
+		return static_cast<uInt32>(index);
+#else
+		return static_cast<uInt32>(31 - __builtin_clz(mask));
+#endif
+	}
+
+	/* Keeps one byte mask bit per character, as movemask returns one per byte */
+	template<typename CharType>
+	constexpr uInt32 _StrLaneBits()
+	{
+		return sizeof(CharType) == 1 ? 0xFFFFFFFFu :
+			sizeof(CharType) == 2 ? 0x55555555u : 0x11111111u;
+	}
+
+#ifdef QUARTZ_STRING_SSE2
+
+	struct _StrVecSse2
+	{
+		using VecType = __m128i;
+
+		constexpr static uSize	BYTES		= 16;
+		constexpr static uInt32	FULL_MASK	= 0xFFFFu;
+
+		template<typename CharType>
+		static VecType Set(CharType c)
+		{
+			if constexpr (sizeof(CharType) == 1)
+			{
+				return _mm_set1_epi8(static_cast<char>(c));
+			}
+			else if constexpr (sizeof(CharType) == 2)
+			{
+				return _mm_set1_epi16(static_cast<short>(c));
+			}
+			else
+			{
+				return _mm_set1_epi32(static_cast<int>(c));
+			}
+		}
+
+		template<typename CharType>
+		QUARTZ_STRING_NO_SANITIZE static VecType Load(const CharType* pStr)
+		{
+			return _mm_loadu_si128(reinterpret_cast<const __m128i*>(pStr));
+		}
+
+		template<typename CharType>
+		static VecType Compare(VecType a, VecType b)
+		{
+			if constexpr (sizeof(CharType) == 1)
+			{
+				return _mm_cmpeq_epi8(a, b);
+			}
+			else if constexpr (sizeof(CharType) == 2)
+			{
+				return _mm_cmpeq_epi16(a, b);
+			}
+			else
+			{
+				return _mm_cmpeq_epi32(a, b);
+			}
+		}
+
+		/* Compares the characters at pStr to the set character */
+		template<typename CharType>
+		static VecType Equal(const CharType* pStr, VecType set)
+		{
+			return Compare<CharType>(Load(pStr), set);
+		}
+
+		static VecType And(VecType a, VecType b)
+		{
+			return _mm_and_si128(a, b);
+		}
+
+		static VecType Or(VecType a, VecType b)
+		{
+			return _mm_or_si128(a, b);
+		}
+
+		/* Returns one bit per byte of a compare result */
+		static uInt32 Mask(VecType v)
+		{
+			return static_cast<uInt32>(_mm_movemask_epi8(v));
+		}
+	};
+
+#endif
+
+#ifdef QUARTZ_STRING_AVX2
+
+	struct _StrVecAvx2
+	{
+		using VecType = __m256i;
+
+		constexpr static uSize	BYTES		= 32;
+		constexpr static uInt32	FULL_MASK	= 0xFFFFFFFFu;
+
+		template<typename CharType>
+		static VecType Set(CharType c)
+		{
+			if constexpr (sizeof(CharType) == 1)
+			{
+				return _mm256_set1_epi8(static_cast<char>(c));
+			}
+			else if constexpr (sizeof(CharType) == 2)
+			{
+				return _mm256_set1_epi16(static_cast<short>(c));
+			}
+			else
+			{
+				return _mm256_set1_epi32(static_cast<int>(c));
+			}
+		}
+
+		template<typename CharType>
+		QUARTZ_STRING_NO_SANITIZE static VecType Load(const CharType* pStr)
+		{
+			return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pStr));
+		}
+
+		template<typename CharType>
+		static VecType Compare(VecType a, VecType b)
+		{
+			if constexpr (sizeof(CharType) == 1)
+			{
+				return _mm256_cmpeq_epi8(a, b);
+			}
+			else if constexpr (sizeof(CharType) == 2)
+			{
+				return _mm256_cmpeq_epi16(a, b);
+			}
+			else
+			{
+				return _mm256_cmpeq_epi32(a, b);
+			}
+		}
+
+		/* Compares the characters at pStr to the set character */
+		template<typename CharType>
+		static VecType Equal(const CharType* pStr, VecType set)
+		{
+			return Compare<CharType>(Load(pStr), set);
+		}
+
+		static VecType And(VecType a, VecType b)
+		{
+			return _mm256_and_si256(a, b);
+		}
+
+		static VecType Or(VecType a, VecType b)
+		{
+			return _mm256_or_si256(a, b);
+		}
+
+		/* Returns one bit per byte of a compare result */
+		static uInt32 Mask(VecType v)
+		{
+			return static_cast<uInt32>(_mm256_movemask_epi8(v));
+		}
+	};
+
+	using _StrVec = _StrVecAvx2;
+
+#elif defined(QUARTZ_STRING_SSE2)
+
+	using _StrVec = _StrVecSse2;
+
+#endif
+
+	/* Returns true if the count characters at pStr1 and pStr2 are equal */
+	template<typename CharType>
+	inline bool _StrEqualCount(const CharType* pStr1, const CharType* pStr2, uSize count)
+	{
+		// Needles are usually short, where a call to memcmp costs more than the compare
+		if (count <= 8)
+		{
+			for (uSize i = 0; i < count; i++)
+			{
+				if (pStr1[i] != pStr2[i])
+				{
+					return false;
+				}
+			}
+
+			return true;
+		}
+
+		return memcmp(pStr1, pStr2, count * sizeof(CharType)) == 0;
+	}
+
+	/* Returns the first c in the length characters at pStr, or nullptr if not found */
+	template<typename CharType>
+	const CharType* StrFindChar(const CharType* pStr, uSize length, CharType c)
+	{
+		for (uSize i = 0; i < length; i++)
+		{
+			if (pStr[i] == c)
+			{
+				return pStr + i;
+			}
+		}
+
+		return nullptr;
+	}
+
+	template<>
+	inline const char* StrFindChar<char>(const char* pStr, uSize length, char c)
+	{
+		return static_cast<const char*>(memchr(pStr, c, length));
+	}
+
+	template<>
+	inline const wchar_t* StrFindChar<wchar_t>(const wchar_t* pStr, uSize length, wchar_t c)
+	{
+		return wmemchr(pStr, c, length);
+	}
+
+	/* Returns the last c in the length characters at pStr, or nullptr if not found */
+	template<typename CharType>
+	const CharType* StrFindCharReverse(const CharType* pStr, uSize length, CharType c)
+	{
+		while (length > 0)
+		{
+			--length;
+
+			if (pStr[length] == c)
+			{
+				return pStr + length;
+			}
+		}
+
+		return nullptr;
+	}
+
+	/* Returns true if c is one of the setLength characters at pSet */
+	template<typename CharType>
+	inline bool _StrIsAny(CharType c, const CharType* pSet, uSize setLength)
+	{
+		for (uSize i = 0; i < setLength; i++)
+		{
+			if (c == pSet[i])
+			{
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	/* The largest set StrFindAny compares in registers, one vector per character */
+	constexpr uSize STRING_MAX_SIMD_SET = 8;
+
+#if defined(QUARTZ_STRING_SSE2)
+
+	template<typename CharType>
+	const CharType* _SimdFindAny(const CharType* pStr, uSize length, const CharType* pSet, uSize setLength)
+	{
+		constexpr uSize LANES = _StrVec::BYTES / sizeof(CharType);
+
+		decltype(_StrVec::Set(pSet[0])) sets[STRING_MAX_SIMD_SET];
+
+		for (uSize j = 0; j < setLength; j++)
+		{
+			sets[j] = _StrVec::Set(pSet[j]);
+		}
+
+		uSize i = 0;
+		for (; i + LANES <= length; i += LANES)
+		{
+			const auto block = _StrVec::Load(pStr + i);
+			auto matches = _StrVec::Compare<CharType>(block, sets[0]);
+
+			for (uSize j = 1; j < setLength; j++)
+			{
+				matches = _StrVec::Or(matches, _StrVec::Compare<CharType>(block, sets[j]));
+			}
+
+			const uInt32 mask = _StrVec::Mask(matches) & _StrLaneBits<CharType>();
+
+			if (mask)
+			{
+				return pStr + i + _StrLowestBit(mask) / sizeof(CharType);
+			}
+		}
+
+		for (; i < length; i++)
+		{
+			if (_StrIsAny(pStr[i], pSet, setLength))
+			{
+				return pStr + i;
+			}
+		}
+
+		return nullptr;
+	}
+
+#endif
+
+	/*
+		Returns the first of any of the setLength characters at pSet in the
+		length characters at pStr, or nullptr if not found. Sets of up to
+		STRING_MAX_SIMD_SET characters are searched a vector at a time.
+	*/
+	template<typename CharType>
+	const CharType* StrFindAny(const CharType* pStr, uSize length, const CharType* pSet, uSize setLength)
+	{
+		if (setLength == 1)
+		{
+			return StrFindChar(pStr, length, pSet[0]);
+		}
+
+#if defined(QUARTZ_STRING_SSE2)
+		if constexpr (sizeof(CharType) == 1 || sizeof(CharType) == 2 || sizeof(CharType) == 4)
+		{
+			if (setLength > 1 && setLength <= STRING_MAX_SIMD_SET)
+			{
+				return _SimdFindAny(pStr, length, pSet, setLength);
+			}
+		}
+#endif
+
+		for (uSize i = 0; i < length; i++)
+		{
+			if (_StrIsAny(pStr[i], pSet, setLength))
+			{
+				return pStr + i;
+			}
+		}
+
+		return nullptr;
+	}
+
+	template<typename CharType>
+	const CharType* _ScalarFind(const CharType* pStr, uSize start, uSize end, const CharType* pSub, uSize subLength)
+	{
+		// Searches match positions [start, end)
+		for (uSize i = start; i < end; i++)
+		{
+			if (pStr[i] == pSub[0] && pStr[i + subLength - 1] == pSub[subLength - 1] &&
+				_StrEqualCount(pStr + i + 1, pSub + 1, subLength - 2))
+			{
+				return pStr + i;
+			}
+		}
+
+		return nullptr;
+	}
+
+	template<typename CharType>
+	const CharType* _ScalarFindReverse(const CharType* pStr, uSize start, uSize end, const CharType* pSub, uSize subLength)
+	{
+		// Searches match positions [start, end) from the back
+		for (uSize i = end; i > start; i--)
+		{
+			const uSize pos = i - 1;
+
+			if (pStr[pos] == pSub[0] && pStr[pos + subLength - 1] == pSub[subLength - 1] &&
+				_StrEqualCount(pStr + pos + 1, pSub + 1, subLength - 2))
+			{
+				return pStr + pos;
+			}
+		}
+
+		return nullptr;
+	}
+
+#if defined(QUARTZ_STRING_SSE2)
+
+	/* Returns a mask of the LANES positions from pStr where both needle ends match */
+	template<typename CharType, typename VecType>
+	inline VecType _SimdCandidates(const CharType* pStr, uSize subLength, VecType first, VecType last)
+	{
+		return _StrVec::And(_StrVec::Equal(pStr, first), _StrVec::Equal(pStr + subLength - 1, last));
+	}
+
+	template<typename CharType>
+	const CharType* _SimdFind(const CharType* pStr, uSize length, const CharType* pSub, uSize subLength)
+	{
+		constexpr uSize LANES = _StrVec::BYTES / sizeof(CharType);
+
+		const auto first	= _StrVec::Set(pSub[0]);
+		const auto last		= _StrVec::Set(pSub[subLength - 1]);
+
+		const uSize positions = length - subLength + 1;
+
+		uSize i = 0;
+		while (i + LANES <= positions)
+		{
+			auto candidates = _SimdCandidates(pStr + i, subLength, first, last);
+
+			// Skip two blocks at a time while neither has a candidate
+			if (i + 2 * LANES <= positions)
+			{
+				const auto candidates2 = _SimdCandidates(pStr + i + LANES, subLength, first, last);
+
+				if (!_StrVec::Mask(_StrVec::Or(candidates, candidates2)))
+				{
+					i += 2 * LANES;
+					continue;
+				}
+			}
+
+			uInt32 mask = _StrVec::Mask(candidates) & _StrLaneBits<CharType>();
+
+			while (mask)
+			{
+				const uSize pos = i + _StrLowestBit(mask) / sizeof(CharType);
+
+				if (_StrEqualCount(pStr + pos + 1, pSub + 1, subLength - 2))
+				{
+					return pStr + pos;
+				}
+
+				mask &= mask - 1;
+			}
+
+			i += LANES;
+		}
+
+		return _ScalarFind(pStr, i, positions, pSub, subLength);
+	}
+
+	template<typename CharType>
+	const CharType* _SimdFindReverse(const CharType* pStr, uSize length, const CharType* pSub, uSize subLength)
+	{
+		constexpr uSize LANES = _StrVec::BYTES / sizeof(CharType);
+
+		const auto first	= _StrVec::Set(pSub[0]);
+		const auto last		= _StrVec::Set(pSub[subLength - 1]);
+
+		// Searches blocks of match positions [end - LANES, end) from the back
+		uSize end = length - subLength + 1;
+		while (end >= LANES)
+		{
+			const uSize i = end - LANES;
+
+			auto candidates = _SimdCandidates(pStr + i, subLength, first, last);
+
+			if (end >= 2 * LANES)
+			{
+				const auto candidates2 = _SimdCandidates(pStr + i - LANES, subLength, first, last);
+
+				if (!_StrVec::Mask(_StrVec::Or(candidates, candidates2)))
+				{
+					end -= 2 * LANES;
+					continue;
+				}
+			}
+
+			uInt32 mask = _StrVec::Mask(candidates) & _StrLaneBits<CharType>();
+
+			while (mask)
+			{
+				const uInt32 bit = _StrHighestBit(mask);
+				const uSize pos = i + bit / sizeof(CharType);
+
+				if (_StrEqualCount(pStr + pos + 1, pSub + 1, subLength - 2))
+				{
+					return pStr + pos;
+				}
+
+				mask &= ~(1u << bit);
+			}
+
+			end = i;
+		}
+
+		return _ScalarFindReverse(pStr, 0, end, pSub, subLength);
+	}
+
+#endif
+
+	/*
+		Returns the first occurrence of the subLength characters at pSub in
+		the length characters at pStr, or nullptr if not found. An empty
+		needle is found at pStr.
+	*/
+	template<typename CharType>
+	const CharType* StrFind(const CharType* pStr, uSize length, const CharType* pSub, uSize subLength)
+	{
+		if (subLength == 0)
+		{
+			return pStr;
+		}
+
+		if (subLength > length)
+		{
+			return nullptr;
+		}
+
+		if (subLength == 1)
+		{
+			return StrFindChar(pStr, length, pSub[0]);
+		}
+
+#if defined(QUARTZ_STRING_SSE2)
+		if constexpr (sizeof(CharType) == 1 || sizeof(CharType) == 2 || sizeof(CharType) == 4)
+		{
+			return _SimdFind(pStr, length, pSub, subLength);
+		}
+		else
+#endif
+		{
+			return _ScalarFind(pStr, 0, length - subLength + 1, pSub, subLength);
+		}
+	}
+
+	/*
+		Returns the last occurrence of the subLength characters at pSub in
+		the length characters at pStr, or nullptr if not found. An empty
+		needle is found at pStr + length.
+	*/
+	template<typename CharType>
+	const CharType* StrFindReverse(const CharType* pStr, uSize length, const CharType* pSub, uSize subLength)
+	{
+		if (subLength == 0)
+		{
+			return pStr + length;
+		}
+
+		if (subLength > length)
+		{
+			return nullptr;
+		}
+
+		if (subLength == 1)
+		{
+			return StrFindCharReverse(pStr, length, pSub[0]);
+		}
+
+#if defined(QUARTZ_STRING_SSE2)
+		if constexpr (sizeof(CharType) == 1 || sizeof(CharType) == 2 || sizeof(CharType) == 4)
+		{
+			return _SimdFindReverse(pStr, length, pSub, subLength);
+		}
+		else
+#endif
+		{
+			return _ScalarFindReverse(pStr, 0, length - subLength + 1, pSub, subLength);
+		}
+	}
+
+	/*
+		Null-terminated scans. A vector load never crosses into the next
+		page unless the string itself does, so reading past the terminator
+		cannot fault: StrLen reads aligned blocks only, and StrCmp falls
+		back to one character at a time near the end of a page.
+	*/
+
+	constexpr uSize STRING_PAGE_SIZE = 4096;
+
+	/* Compares two characters as strcmp/wcscmp would */
+	template<typename CharType>
+	inline sSize _StrCharDiff(CharType c1, CharType c2)
+	{
+		if constexpr (sizeof(CharType) == 1)
+		{
+			return static_cast<sSize>(static_cast<uInt8>(c1)) - static_cast<sSize>(static_cast<uInt8>(c2));
+		}
+		else
+		{
+			return c1 < c2 ? -1 : (c2 < c1 ? 1 : 0);
+		}
+	}
+
+#if defined(QUARTZ_STRING_SSE2)
+
+	/* Returns the number of bytes from pData to the end of its page */
+	inline uSize _StrBytesToPageEnd(const void* pData)
+	{
+		return STRING_PAGE_SIZE - static_cast<uSize>(reinterpret_cast<std::uintptr_t>(pData) & (STRING_PAGE_SIZE - 1));
+	}
+
+	/* Returns a byte mask of the terminators in the block at pBlock */
+	template<typename CharType, typename VecType>
+	inline uInt32 _StrZeroMask(const CharType* pBlock, VecType zero)
+	{
+		return _StrVec::Mask(_StrVec::Equal(pBlock, zero)) & _StrLaneBits<CharType>();
+	}
+
+	template<typename CharType>
+	QUARTZ_STRING_NO_SANITIZE uSize _SimdStrLen(const CharType* pStr)
+	{
+		constexpr uSize LANES		= _StrVec::BYTES / sizeof(CharType);
+		constexpr uSize GROUP_BYTES	= 4 * _StrVec::BYTES;
+
+		const auto zero = _StrVec::Set(CharType(0));
+
+		const std::uintptr_t address	= reinterpret_cast<std::uintptr_t>(pStr);
+		const uInt32 offset				= static_cast<uInt32>(address & (_StrVec::BYTES - 1));
+
+		const CharType* pBlock = reinterpret_cast<const CharType*>(address - offset);
+
+		// Ignore terminators in the block before the start of the string
+		uInt32 mask = _StrZeroMask(pBlock, zero) & (_StrVec::FULL_MASK << offset);
+
+		// Single blocks up to a group boundary, then groups of four aligned blocks
+		while (!mask && (reinterpret_cast<std::uintptr_t>(pBlock + LANES) & (GROUP_BYTES - 1)) != 0)
+		{
+			pBlock += LANES;
+			mask = _StrZeroMask(pBlock, zero);
+		}
+
+		if (!mask)
+		{
+			pBlock += LANES;
+
+			while (true)
+			{
+				const auto zeros01 = _StrVec::Or(_StrVec::Equal(pBlock, zero), _StrVec::Equal(pBlock + LANES, zero));
+				const auto zeros23 = _StrVec::Or(_StrVec::Equal(pBlock + 2 * LANES, zero), _StrVec::Equal(pBlock + 3 * LANES, zero));
+
+				if (_StrVec::Mask(_StrVec::Or(zeros01, zeros23)))
+				{
+					break;
+				}
+
+				pBlock += 4 * LANES;
+			}
+
+			while (!(mask = _StrZeroMask(pBlock, zero)))
+			{
+				pBlock += LANES;
+			}
+		}
+
+		return static_cast<uSize>(pBlock - pStr) + _StrLowestBit(mask) / sizeof(CharType);
+	}
+
+	template<typename CharType>
+	QUARTZ_STRING_NO_SANITIZE sSize _SimdStrCmp(const CharType* pStr1, const CharType* pStr2, uSize count)
+	{
+		constexpr uSize LANES = _StrVec::BYTES / sizeof(CharType);
+
+		const auto zero = _StrVec::Set(CharType(0));
+
+		uSize i = 0;
+		while (i < count)
+		{
+			const uSize bytes1 = _StrBytesToPageEnd(pStr1 + i);
+			const uSize bytes2 = _StrBytesToPageEnd(pStr2 + i);
+
+			// Characters that can be loaded from both strings without crossing a page
+			const uSize safeCount = (bytes1 < bytes2 ? bytes1 : bytes2) / sizeof(CharType);
+
+			if (safeCount < LANES)
+			{
+				if (pStr1[i] != pStr2[i] || pStr1[i] == CharType(0))
+				{
+					return _StrCharDiff(pStr1[i], pStr2[i]);
+				}
+
+				i++;
+				continue;
+			}
+
+			// Block starts that stay within the safe characters and before count
+			const uSize safeLimit	= i + safeCount - LANES + 1;
+			const uSize limit		= safeLimit < count ? safeLimit : count;
+
+			while (i < limit)
+			{
+				const auto block1 = _StrVec::Load(pStr1 + i);
+				const auto block2 = _StrVec::Load(pStr2 + i);
+
+				// Stop at the first differing character or terminator
+				auto stops = _StrVec::Or(_StrVec::Compare<CharType>(_StrVec::Compare<CharType>(block1, block2), zero),
+					_StrVec::Compare<CharType>(block1, zero));
+
+				uSize stopIndex = i;
+
+				if (i + LANES < limit)
+				{
+					const auto next1 = _StrVec::Load(pStr1 + i + LANES);
+					const auto next2 = _StrVec::Load(pStr2 + i + LANES);
+
+					const auto nextStops = _StrVec::Or(_StrVec::Compare<CharType>(_StrVec::Compare<CharType>(next1, next2), zero),
+						_StrVec::Compare<CharType>(next1, zero));
+
+					if (!_StrVec::Mask(_StrVec::Or(stops, nextStops)))
+					{
+						i += 2 * LANES;
+						continue;
+					}
+
+					if (!_StrVec::Mask(stops))
+					{
+						stops = nextStops;
+						stopIndex = i + LANES;
+					}
+				}
+
+				const uInt32 mask = _StrVec::Mask(stops) & _StrLaneBits<CharType>();
+
+				if (mask)
+				{
+					const uSize pos = stopIndex + _StrLowestBit(mask) / sizeof(CharType);
+					return pos < count ? _StrCharDiff(pStr1[pos], pStr2[pos]) : 0;
+				}
+
+				i += LANES;
+			}
+		}
+
+		return 0;
+	}
+
+#endif
+}
\ No newline at end of file
@@ -0,0 +1,165 @@
+#include "Types/BTree.h"
+
+#include "Test.h"
+
+#include <map>
+#include <set>
+
+using namespace Quartz;
+
+/*====================================================
+|               QUARTZLIB B-TREE TESTS               |
+=====================================================*/
+
+/* Checks size, order and contents of map against expected */
+static void CheckSame(const BTreeMap<int, int>& map, const std::map<int, int>& expected)
+{
+	CHECK(map.Size() == expected.size());
+
+	auto expectedIt = expected.begin();
+
+	for (auto it = map.Begin(); it != map.End(); ++it, ++expectedIt)
+	{
+		if (expectedIt == expected.end())
+		{
+			CHECK(false);
+			return;
+		}
+
+		CHECK(it->key == expectedIt->first && it->value == expectedIt->second);
+	}
+
+	CHECK(expectedIt == expected.end());
+}
+
+static void TestRandomOps()
+{
+	BTreeMap<int, int> map;
+	std::map<int, int> expected;
+
+	for (int i = 0; i < 20000; i++)
+	{
+		const int key = static_cast<int>(TestRandom() % 4000);
+
+		if (TestRandom() % 3 == 0)
+		{
+			CHECK(map.Remove(key) == (expected.erase(key) == 1));
+		}
+		else
+		{
+			map.Put(key, i);
+			expected[key] = i;
+		}
+	}
+
+	CheckSame(map, expected);
+
+	for (int key = 0; key < 4000; key++)
+	{
+		CHECK(map.Contains(key) == (expected.count(key) == 1));
+	}
+
+	BTreeMap<int, int> copy(map);
+	CheckSame(copy, expected);
+
+	for (const auto& pair : expected)
+	{
+		CHECK(map.Remove(pair.first));
+	}
+
+	CHECK(map.Size() == 0);
+	CHECK(map.Begin() == map.End());
+	CheckSame(copy, expected);
+}
+
+static void TestBounds()
+{
+	BTreeMap<int, int> map;
+	std::map<int, int> expected;
+
+	for (int i = 0; i < 1000; i++)
+	{
+		map.Put(i * 2, i);
+		expected[i * 2] = i;
+	}
+
+	for (int key = -1; key < 2002; key++)
+	{
+		auto lower = map.LowerBound(key);
+		auto expectedLower = expected.lower_bound(key);
+		CHECK((lower == map.End()) == (expectedLower == expected.end()));
+
+		if (lower != map.End() && expectedLower != expected.end())
+		{
+			CHECK(lower->key == expectedLower->first);
+		}
+
+		auto upper = map.UpperBound(key);
+		auto expectedUpper = expected.upper_bound(key);
+		CHECK((upper == map.End()) == (expectedUpper == expected.end()));
+
+		if (upper != map.End() && expectedUpper != expected.end())
+		{
+			CHECK(upper->key == expectedUpper->first);
+		}
+	}
+
+	int count = 0;
+
+	for (const auto& pair : map.Range(100, 200))
+	{
+		CHECK(pair.key >= 100 && pair.key < 200);
+		count++;
+	}
+
+	CHECK(count == 50);
+
+	auto last = map.Last();
+	CHECK(last->key == 1998);
+	--last;
+	CHECK(last->key == 1996);
+}
+
+static void TestBuildSorted()
+{
+	int keys[3000];
+	int values[3000];
+
+	for (int i = 0; i < 3000; i++)
+	{
+		keys[i] = i * 3;
+		values[i] = -i;
+	}
+
+	BTreeMap<int, int> map(keys, values, 3000);
+	CHECK(map.Size() == 3000);
+	CHECK(map.Find(2997)->value == -999);
+	CHECK(!map.Contains(1));
+
+	map.Put(1, 1);
+	CHECK(map.Remove(0));
+	CHECK(map.Begin()->key == 1);
+
+	BTreeSet<int> set(keys, 3000);
+	std::set<int> expected(keys, keys + 3000);
+	CHECK(!set.Add(3));
+	CHECK(set.Add(4));
+	expected.insert(4);
+	CHECK(set.Size() == expected.size());
+
+	auto expectedIt = expected.begin();
+
+	for (int key : set)
+	{
+		CHECK(key == *expectedIt++);
+	}
+}
+
+int main()
+{
+	TestRandomOps();
+	TestBounds();
+	TestBuildSorted();
+
+	return TEST_RESULT();
+}
\ No newline at end of file
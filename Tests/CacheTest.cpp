@@ -0,0 +1,214 @@
+#include "Types/Cache.h"
+#include "Types/String.h"
+
+#include "Test.h"
+
+#include <list>
+#include <unordered_map>
+
+using namespace Quartz;
+
+/*====================================================
+|               QUARTZLIB CACHE TESTS                |
+=====================================================*/
+
+static void TestLruOrder()
+{
+	LruCache<int, int> cache(3);
+	cache.Put(1, 10);
+	cache.Put(2, 20);
+	cache.Put(3, 30);
+	CHECK(*cache.Find(1) == 10);
+
+	cache.Put(4, 40);
+	CHECK(!cache.Contains(2));
+	CHECK(cache.Size() == 3);
+
+	int order[3];
+	int count = 0;
+	cache.ForEach([&](int key, int) { order[count++] = key; });
+	CHECK(count == 3 && order[0] == 4 && order[1] == 1 && order[2] == 3);
+
+	CHECK(cache.Find(2) == nullptr);
+	CHECK(*cache.Peek(3) == 30);
+
+	const CacheStats stats = cache.GetStats();
+	CHECK(stats.hits == 1 && stats.misses == 1);
+	CHECK(stats.insertions == 4 && stats.evictions == 1);
+
+	CHECK(cache.Remove(1));
+	CHECK(!cache.Remove(1));
+	CHECK(cache.Size() == 2);
+
+	cache.SetCapacity(1);
+	CHECK(cache.Size() == 1 && cache.Contains(4));
+
+	cache.Clear();
+	CHECK(cache.IsEmpty() && cache.Cost() == 0);
+}
+
+static void TestLruCost()
+{
+	LruCache<String, int> cache(10);
+	cache.Put("a", 1, 4);
+	cache.Put("b", 2, 4);
+	CHECK(cache.Cost() == 8);
+
+	cache.Put("c", 3, 4);
+	CHECK(!cache.Contains("a"));
+	CHECK(cache.Cost() == 8);
+
+	// An entry larger than the capacity is kept alone
+	cache.Put("d", 4, 20);
+	CHECK(cache.Size() == 1 && cache.Contains("d"));
+}
+
+static void TestLruModel()
+{
+	const uSize capacity = 64;
+
+	LruCache<int, int> cache(capacity);
+	std::list<int> recency;
+	std::unordered_map<int, int> values;
+
+	auto touch = [&](int key)
+	{
+		recency.remove(key);
+		recency.push_front(key);
+	};
+
+	for (int i = 0; i < 20000; i++)
+	{
+		const int key = static_cast<int>(TestRandom() % 200);
+
+		if (TestRandom() % 2 == 0)
+		{
+			int* pValue = cache.Find(key);
+			CHECK((pValue != nullptr) == (values.count(key) == 1));
+
+			if (pValue)
+			{
+				CHECK(*pValue == values[key]);
+				touch(key);
+			}
+		}
+		else
+		{
+			cache.Put(key, i);
+			values[key] = i;
+			touch(key);
+
+			if (recency.size() > capacity)
+			{
+				values.erase(recency.back());
+				recency.pop_back();
+			}
+		}
+	}
+
+	CHECK(cache.Size() == recency.size());
+
+	auto it = recency.begin();
+	cache.ForEach([&](int key, int value)
+	{
+		CHECK(it != recency.end() && key == *it && value == values[key]);
+		++it;
+	});
+}
+
+static void TestS3FifoScan()
+{
+	S3FifoCache<int, int> cache(20);
+
+	for (int key = 0; key < 10; key++)
+	{
+		cache.Put(key, key);
+		cache.Find(key);
+	}
+
+	// One-hit keys pass through the small FIFO without evicting the hot keys
+	for (int key = 100; key < 1100; key++)
+	{
+		cache.Put(key, key);
+		CHECK(cache.Size() <= 20 && cache.Cost() <= 20);
+	}
+
+	for (int key = 0; key < 10; key++)
+	{
+		CHECK(cache.Contains(key));
+		CHECK(*cache.Find(key) == key);
+	}
+
+	LruCache<int, int> lru(20);
+
+	for (int key = 0; key < 10; key++)
+	{
+		lru.Put(key, key);
+		lru.Find(key);
+	}
+
+	for (int key = 100; key < 1100; key++)
+	{
+		lru.Put(key, key);
+	}
+
+	CHECK(!lru.Contains(0));
+}
+
+static void TestS3FifoModel()
+{
+	S3FifoCache<int, int> cache(50);
+	std::unordered_map<int, int> values;
+
+	for (int i = 0; i < 20000; i++)
+	{
+		const int key = static_cast<int>(TestRandom() % 300);
+
+		if (TestRandom() % 4 == 0)
+		{
+			const bool contained = cache.Contains(key);
+			CHECK(cache.Remove(key) == contained);
+			CHECK(!cache.Contains(key));
+			values.erase(key);
+		}
+		else if (TestRandom() % 2 == 0)
+		{
+			cache.Put(key, i);
+			values[key] = i;
+		}
+		else
+		{
+			int* pValue = cache.Find(key);
+			CHECK(pValue == nullptr || *pValue == values[key]);
+		}
+
+		CHECK(cache.Size() <= 50);
+	}
+
+	uSize count = 0;
+	cache.ForEach([&](int key, int value)
+	{
+		CHECK(values.count(key) == 1 && values[key] == value);
+		count++;
+	});
+
+	CHECK(count == cache.Size());
+
+	S3FifoCache<int, int> copy(cache);
+	CHECK(copy.Size() == cache.Size());
+
+	cache.Clear();
+	CHECK(cache.IsEmpty() && cache.Cost() == 0);
+	CHECK(!copy.IsEmpty());
+}
+
+int main()
+{
+	TestLruOrder();
+	TestLruCost();
+	TestLruModel();
+	TestS3FifoScan();
+	TestS3FifoModel();
+
+	return TEST_RESULT();
+}
\ No newline at end of file
@@ -0,0 +1,142 @@
+#include "Types/ConcurrentMap.h"
+#include "Types/Map.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace Quartz;
+
+/*====================================================
+|         QUARTZLIB CONCURRENT MAP BENCHMARK         |
+=====================================================*/
+
+/*
+	Compares ConcurrentMap against a Map behind one std::mutex, from 1 to
+	64 threads, on a read-only and a 90% read workload. The operation
+	count is split across the threads, so each row does the same work.
+	Pass an operation count to override the default.
+
+	This is not run by ctest, build and run ConcurrentMapBenchmark.
+*/
+
+constexpr uInt64 KEY_COUNT		= 1 << 16;
+constexpr uSize	 MAX_THREADS	= 64;
+
+/* Runs body(thread, opCount) on threadCount threads, returns the wall time in seconds */
+template<typename Body>
+static double TimeThreads(uSize threadCount, uInt64 totalOps, Body body)
+{
+	std::vector<std::thread> threads;
+	const auto start = std::chrono::steady_clock::now();
+
+	for (uSize t = 0; t < threadCount; t++)
+	{
+		threads.emplace_back(body, t, totalOps / threadCount);
+	}
+
+	for (std::thread& thread : threads)
+	{
+		thread.join();
+	}
+
+	return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+/* A per-thread xorshift generator */
+static uInt64 NextKey(uInt64& state)
+{
+	state ^= state << 13;
+	state ^= state >> 7;
+	state ^= state << 17;
+	return state % KEY_COUNT;
+}
+
+template<typename FindFunc, typename PutFunc>
+static double Run(uSize threadCount, uInt64 totalOps, uInt64 writePercent, FindFunc find, PutFunc put)
+{
+	std::atomic<uInt64> sink(0);
+
+	const double seconds = TimeThreads(threadCount, totalOps, [&](uSize thread, uInt64 opCount)
+	{
+		uInt64 state = 0x9E3779B97F4A7C15ull * (thread + 1);
+		uInt64 sum = 0;
+
+		for (uInt64 i = 0; i < opCount; i++)
+		{
+			const uInt64 key = NextKey(state);
+
+			if (writePercent && (state >> 32) % 100 < writePercent)
+			{
+				put(key, i);
+			}
+			else
+			{
+				sum += find(key);
+			}
+		}
+
+		sink.fetch_add(sum, std::memory_order_relaxed);
+	});
+
+	return totalOps / seconds / 1e6;
+}
+
+int main(int argc, char** argv)
+{
+	const uInt64 totalOps = argc > 1 ? strtoull(argv[1], nullptr, 10) : 4000000;
+
+	ConcurrentMap<uInt64, uInt64> concurrentMap;
+	Map<uInt64, uInt64> mutexMap;
+	std::mutex mutex;
+
+	for (uInt64 key = 0; key < KEY_COUNT; key++)
+	{
+		concurrentMap.Put(key, key);
+		mutexMap.Put(key, key);
+	}
+
+	auto concurrentFind = [&](uInt64 key)
+	{
+		uInt64 value = 0;
+		concurrentMap.Find(key, value);
+		return value;
+	};
+
+	auto concurrentPut = [&](uInt64 key, uInt64 value)
+	{
+		concurrentMap.Put(key, value);
+	};
+
+	auto mutexFind = [&](uInt64 key)
+	{
+		std::lock_guard<std::mutex> guard(mutex);
+		return mutexMap.Get(key);
+	};
+
+	auto mutexPut = [&](uInt64 key, uInt64 value)
+	{
+		std::lock_guard<std::mutex> guard(mutex);
+		mutexMap.Put(key, value);
+	};
+
+	printf("%u hardware threads, %llu operations per row, Mops/s\n\n",
+		std::thread::hardware_concurrency(), static_cast<unsigned long long>(totalOps));
+	printf("threads | read-only: concurrent  mutex | 10%% writes: concurrent  mutex\n");
+
+	for (uSize threadCount = 1; threadCount <= MAX_THREADS; threadCount *= 2)
+	{
+		const double concurrentRead	= Run(threadCount, totalOps, 0, concurrentFind, concurrentPut);
+		const double mutexRead		= Run(threadCount, totalOps, 0, mutexFind, mutexPut);
+		const double concurrentMixed	= Run(threadCount, totalOps, 10, concurrentFind, concurrentPut);
+		const double mutexMixed		= Run(threadCount, totalOps, 10, mutexFind, mutexPut);
+
+		printf("%7zu | %20.1f %6.1f | %21.1f %6.1f\n", static_cast<size_t>(threadCount),
+			concurrentRead, mutexRead, concurrentMixed, mutexMixed);
+	}
+
+	return 0;
+}
\ No newline at end of file
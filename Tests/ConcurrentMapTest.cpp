@@ -0,0 +1,176 @@
+#include "Types/ConcurrentMap.h"
+#include "Types/String.h"
+
+#include "Test.h"
+
+#include <atomic>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+using namespace Quartz;
+
+/*====================================================
+|           QUARTZLIB CONCURRENT MAP TESTS           |
+=====================================================*/
+
+static_assert(ConcurrentMap<uInt64, uInt64>::OPTIMISTIC_READS, "Integer maps should read without locking.");
+static_assert(!ConcurrentMap<String, int>::OPTIMISTIC_READS, "String maps must read under the shard lock.");
+
+static void TestModel()
+{
+	ConcurrentMap<int, int, 4> map;
+	std::unordered_map<int, int> expected;
+
+	for (int i = 0; i < 50000; i++)
+	{
+		const int key = static_cast<int>(TestRandom() % 3000);
+		const uInt64 op = TestRandom() % 4;
+
+		if (op == 0)
+		{
+			CHECK(map.Remove(key) == (expected.erase(key) == 1));
+		}
+		else if (op == 1)
+		{
+			map.Update(key, [](int& value) { value++; });
+			expected[key]++;
+		}
+		else
+		{
+			map.Put(key, i);
+			expected[key] = i;
+		}
+	}
+
+	CHECK(map.Size() == expected.size());
+
+	for (int key = 0; key < 3000; key++)
+	{
+		int value = -1;
+		const bool found = map.Find(key, value);
+		CHECK(found == (expected.count(key) == 1));
+		CHECK(!found || value == expected[key]);
+		CHECK(map.Contains(key) == found);
+	}
+
+	map.Clear();
+	CHECK(map.IsEmpty());
+	CHECK(!map.Contains(0));
+
+	map.Reserve(10000);
+	map.Put(7, 7);
+	CHECK(map.Size() == 1 && map.Contains(7));
+}
+
+/*
+	Readers race writers that grow, overwrite, remove and clear shards.
+	Every value stores its key in the high bits, so a torn or misplaced
+	read is caught by checking that the value belongs to its key.
+*/
+static void TestRacingReaders()
+{
+	constexpr uInt64 KEY_COUNT = 20000;
+
+	ConcurrentMap<uInt64, uInt64, 8> map;
+	std::atomic<bool> done(false);
+	std::atomic<uSize> mismatches(0);
+	std::atomic<uSize> hits(0);
+
+	std::vector<std::thread> threads;
+
+	for (uSize t = 0; t < 2; t++)
+	{
+		threads.emplace_back([&, t]()
+		{
+			for (uInt64 round = 0; round < 4; round++)
+			{
+				for (uInt64 key = t; key < KEY_COUNT; key += 2)
+				{
+					map.Put(key, (key << 20) | round);
+				}
+
+				for (uInt64 key = t; key < KEY_COUNT; key += 6)
+				{
+					map.Remove(key);
+				}
+			}
+
+			map.Clear();
+		});
+	}
+
+	for (uSize t = 0; t < 2; t++)
+	{
+		threads.emplace_back([&]()
+		{
+			while (!done.load(std::memory_order_relaxed))
+			{
+				for (uInt64 key = 0; key < KEY_COUNT; key += 7)
+				{
+					uInt64 value = 0;
+
+					if (map.Find(key, value))
+					{
+						hits.fetch_add(1, std::memory_order_relaxed);
+
+						if ((value >> 20) != key)
+						{
+							mismatches.fetch_add(1, std::memory_order_relaxed);
+						}
+					}
+				}
+			}
+		});
+	}
+
+	threads[0].join();
+	threads[1].join();
+	done.store(true);
+	threads[2].join();
+	threads[3].join();
+
+	CHECK(mismatches.load() == 0);
+	CHECK(map.IsEmpty());
+
+	printf("Racing reads: %llu hits\n", static_cast<unsigned long long>(hits.load()));
+}
+
+static void TestLockedReaders()
+{
+	ConcurrentMap<String, int, 4> map;
+	std::vector<std::thread> threads;
+
+	threads.emplace_back([&]()
+	{
+		for (int i = 0; i < 5000; i++)
+		{
+			map.Put(String("key") + String(i % 100), i);
+		}
+	});
+
+	threads.emplace_back([&]()
+	{
+		for (int i = 0; i < 5000; i++)
+		{
+			int value = 0;
+			map.Find(String("key") + String(i % 100), value);
+		}
+	});
+
+	for (std::thread& thread : threads)
+	{
+		thread.join();
+	}
+
+	CHECK(map.Size() == 100);
+}
+
+int main()
+{
+	TestModel();
+	TestRacingReaders();
+	TestLockedReaders();
+
+	return TEST_RESULT();
+}
\ No newline at end of file
@@ -0,0 +1,128 @@
+#include "Types/BloomFilter.h"
+#include "Types/CuckooFilter.h"
+#include "Types/String.h"
+
+#include "Test.h"
+
+using namespace Quartz;
+
+/*====================================================
+|               QUARTZLIB FILTER TESTS               |
+=====================================================*/
+
+static void TestBloom()
+{
+	BloomFilter filter(10000, 0.01);
+
+	for (uInt64 key = 0; key < 10000; key++)
+	{
+		filter.Add(key);
+	}
+
+	for (uInt64 key = 0; key < 10000; key++)
+	{
+		CHECK(filter.MayContain(key));
+	}
+
+	uSize falsePositives = 0;
+
+	for (uInt64 key = 1000000; key < 1100000; key++)
+	{
+		falsePositives += filter.MayContain(key) ? 1 : 0;
+	}
+
+	// 1% requested, with some room for the blocked layout
+	CHECK(falsePositives < 2000);
+
+	BloomFilter other(10000, 0.01);
+	other.Add(uInt64(5000000));
+	CHECK(filter.Merge(other));
+	CHECK(filter.MayContain(uInt64(5000000)));
+	CHECK(filter.MayContain(uInt64(0)));
+
+	BloomFilter smaller(10, 0.01);
+	CHECK(!filter.Merge(smaller));
+
+	filter.Clear();
+	CHECK(!filter.MayContain(uInt64(0)));
+
+	BloomFilter strings(100, 0.01);
+	strings.Add(String("texture"));
+	CHECK(strings.MayContain(String("texture")));
+}
+
+static void TestCuckoo()
+{
+	CuckooFilter filter(10000);
+
+	for (uInt64 key = 0; key < 10000; key++)
+	{
+		CHECK(filter.Add(key));
+	}
+
+	CHECK(filter.Size() == 10000);
+
+	for (uInt64 key = 0; key < 10000; key++)
+	{
+		CHECK(filter.MayContain(key));
+	}
+
+	uSize falsePositives = 0;
+
+	for (uInt64 key = 1000000; key < 1100000; key++)
+	{
+		falsePositives += filter.MayContain(key) ? 1 : 0;
+	}
+
+	CHECK(falsePositives < 1000);
+
+	for (uInt64 key = 0; key < 10000; key += 2)
+	{
+		CHECK(filter.Remove(key));
+	}
+
+	CHECK(filter.Size() == 5000);
+
+	for (uInt64 key = 1; key < 10000; key += 2)
+	{
+		CHECK(filter.MayContain(key));
+	}
+
+	filter.Clear();
+	CHECK(filter.Size() == 0 && !filter.MayContain(uInt64(1)));
+}
+
+static void TestCuckooFull()
+{
+	CuckooFilter filter(16);
+	uSize added = 0;
+
+	for (uInt64 key = 0; key < 1000; key++)
+	{
+		if (!filter.Add(key))
+		{
+			break;
+		}
+
+		added++;
+	}
+
+	CHECK(added < 1000);
+	CHECK(filter.IsFull());
+	CHECK(added <= filter.Capacity() + 1);
+
+	// Every key added before the filter filled must still be found
+	for (uInt64 key = 0; key < added; key++)
+	{
+		CHECK(filter.MayContain(key));
+	}
+}
+
+int main()
+{
+	TestBloom();
+	TestCuckoo();
+	TestCuckooFull();
+
+	return TEST_RESULT();
+}
\ No newline at end of file
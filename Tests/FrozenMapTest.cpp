@@ -0,0 +1,162 @@
+#include "Types/FrozenMap.h"
+#include "Types/Map.h"
+#include "Types/String.h"
+
+#include "Test.h"
+
+#include <unordered_map>
+
+using namespace Quartz;
+
+/*====================================================
+|             QUARTZLIB FROZEN MAP TESTS             |
+=====================================================*/
+
+/* A key whose hash ignores its value, so that no seed can place many of them */
+struct CollidingKey
+{
+	int value;
+
+	bool operator==(const CollidingKey& key) const
+	{
+		return value == key.value;
+	}
+};
+
+namespace Quartz
+{
+	template<>
+	struct Hasher<CollidingKey>
+	{
+		static hash64 HashValue(const CollidingKey&)
+		{
+			return 1;
+		}
+	};
+}
+
+static void TestFromMap()
+{
+	Map<uInt64, uInt64> map;
+	std::unordered_map<uInt64, uInt64> expected;
+
+	for (uSize i = 0; i < 5000; i++)
+	{
+		const uInt64 key = TestRandom() % 100000;
+		map.Put(key, i);
+		expected[key] = i;
+	}
+
+	FrozenMap<uInt64, uInt64> frozen(map);
+	CHECK(frozen.Size() == expected.size());
+
+	for (const auto& pair : expected)
+	{
+		const uInt64* pValue = frozen.Get(pair.first);
+		CHECK(pValue != nullptr && *pValue == pair.second);
+	}
+
+	for (uInt64 key = 100000; key < 101000; key++)
+	{
+		CHECK(!frozen.Contains(key));
+		CHECK(frozen.Find(key) == frozen.End());
+	}
+
+	uSize count = 0;
+
+	for (const auto& pair : frozen)
+	{
+		CHECK(expected.count(pair.key) == 1 && expected[pair.key] == pair.value);
+		count++;
+	}
+
+	CHECK(count == expected.size());
+}
+
+static void TestFromArrays()
+{
+	const int keys[]	= { 3, 1, 4, 1, 5, 9, 2, 6, 5, 3 };
+	const int values[]	= { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9 };
+
+	FrozenMap<int, int> frozen(keys, values, 10);
+	CHECK(frozen.IsValid());
+	CHECK(frozen.Size() == 7);
+	CHECK(*frozen.Get(1) == 3);
+	CHECK(*frozen.Get(3) == 9);
+	CHECK(*frozen.Get(5) == 8);
+	CHECK(*frozen.Get(9) == 5);
+	CHECK(frozen.Get(7) == nullptr);
+}
+
+static void TestStrings()
+{
+	Map<String, int> map;
+	map.Put("alpha", 1);
+	map.Put("beta", 2);
+	map.Put("gamma", 3);
+
+	FrozenMap<String, int> frozen(map);
+	CHECK(*frozen.Get("alpha") == 1);
+	CHECK(*frozen.Get(WrapperString("beta")) == 2);
+	CHECK(*frozen.Get(String("gamma")) == 3);
+	CHECK(!frozen.Contains("delta"));
+}
+
+static void TestCopyAndEmpty()
+{
+	FrozenMap<int, int> empty;
+	CHECK(empty.IsEmpty() && empty.IsValid());
+	CHECK(!empty.Contains(0));
+	CHECK(empty.Begin() == empty.End());
+
+	const int keys[]	= { 10, 20, 30 };
+	const int values[]	= { 1, 2, 3 };
+
+	FrozenMap<int, int> frozen(keys, values, 3);
+	FrozenMap<int, int> copy(frozen);
+	CHECK(copy.Size() == 3 && *copy.Get(20) == 2);
+
+	FrozenMap<int, int> moved(Move(copy));
+	CHECK(moved.Size() == 3 && *moved.Get(30) == 3);
+
+	empty = frozen;
+	CHECK(empty.Size() == 3 && *empty.Get(10) == 1);
+}
+
+static void TestInvalid()
+{
+	CollidingKey keys[64];
+	int values[64];
+
+	for (int i = 0; i < 64; i++)
+	{
+		keys[i].value = i;
+		values[i] = i;
+	}
+
+	// A single key always places
+	FrozenMap<CollidingKey, int> pair(keys, values, 1);
+	CHECK(pair.IsValid() && pair.Size() == 1);
+
+	// Failing to place the keys asserts in debug builds
+#ifdef NDEBUG
+	FrozenMap<CollidingKey, int> invalid(keys, values, 64);
+	CHECK(!invalid.IsValid());
+	CHECK(invalid.IsEmpty());
+	CHECK(!invalid.Contains(keys[0]));
+
+	FrozenMap<CollidingKey, int> moved(Move(invalid));
+	CHECK(!moved.IsValid());
+#endif
+}
+
+int main()
+{
+	TestFromMap();
+	TestFromArrays();
+	TestStrings();
+	TestCopyAndEmpty();
+	TestInvalid();
+
+	return TEST_RESULT();
+}
\ No newline at end of file
@@ -0,0 +1,11 @@
+#include "QuartzLib.h"
+
+/*
+	Includes every public header, so a header that does not compile
+	on its own fails the build.
+*/
+
+int main()
+{
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,111 @@
+#include "Types/String.h"
+#include "Types/Map.h"
+#include "Types/Set.h"
+#include "Types/CountMap.h"
+#include "Types/MultiMap.h"
+#include "Types/ConcurrentMap.h"
+
+#include "Test.h"
+
+using namespace Quartz;
+
+/*====================================================
+|          QUARTZLIB KEY CONVERSION TESTS            |
+=====================================================*/
+
+/*
+	Keys passed as another type than KeyType must hash and compare as
+	the KeyType they convert to, whichever call they are passed to.
+*/
+
+static void TestMap()
+{
+	Map<int64, int> intMap;
+	intMap.Get(-1);
+	intMap.Put(int64(-1), 5);
+	CHECK(intMap.Size() == 1);
+	CHECK(intMap.Get(-1) == 5);
+	CHECK(intMap.Contains(-1));
+	intMap.Remove(-1);
+	CHECK(intMap.IsEmpty());
+
+	Map<float, int> floatMap;
+	floatMap.Put(1.0f, 3);
+	CHECK(floatMap.Find(1) != floatMap.End());
+	CHECK(floatMap.Contains(1));
+	CHECK(floatMap.Get(1) == 3);
+	floatMap.Remove(1);
+	CHECK(!floatMap.Contains(1.0f));
+
+	Set<double> doubleSet;
+	doubleSet.Add(2.0);
+	CHECK(doubleSet.Contains(2));
+	doubleSet.Remove(2);
+	CHECK(!doubleSet.Contains(2.0));
+
+	Map<String, int> stringMap;
+	stringMap.Put(String("key"), 1);
+	stringMap.Get("other");
+	CHECK(stringMap.Size() == 2);
+	CHECK(stringMap.Contains("key"));
+	CHECK(stringMap.Contains(WrapperString("key")));
+	CHECK(stringMap.Contains(String("other")));
+}
+
+static void TestConcurrentMap()
+{
+	ConcurrentMap<float, int> floatMap;
+	int value = 0;
+	floatMap.Put(1.0f, 7);
+	CHECK(floatMap.Find(1, value) && value == 7);
+	floatMap.Update(1, [](int& count) { ++count; });
+	CHECK(floatMap.Find(1.0f, value) && value == 8);
+	CHECK(floatMap.Remove(1));
+	CHECK(!floatMap.Contains(1.0f));
+}
+
+static void TestCountMap()
+{
+	CountMap<int64> intCounts;
+	intCounts.Increment(-3);
+	intCounts.Increment(int64(-3));
+	CHECK(intCounts.Size() == 1);
+	CHECK(intCounts.Count(-3) == 2);
+
+	CountMap<double> doubleCounts;
+	doubleCounts.Increment(2);
+	CHECK(doubleCounts.Count(2.0) == 1);
+	doubleCounts.Increment(2.0f);
+	CHECK(doubleCounts.Count(2) == 2);
+
+	CountMap<String> stringCounts;
+	stringCounts.Increment("word");
+	stringCounts.Increment(String("word"));
+	stringCounts.Increment(WrapperString("word"));
+	CHECK(stringCounts.Size() == 1);
+	CHECK(stringCounts.Count("word") == 3);
+}
+
+static void TestMultiMap()
+{
+	MultiMap<int64, int> intMulti;
+	intMulti.Put(-3, 1);
+	intMulti.Put(int64(-3), 2);
+	CHECK(intMulti.Count(-3) == 2);
+
+	MultiMap<double, int> doubleMulti;
+	doubleMulti.Put(2, 1);
+	doubleMulti.Put(2.0, 2);
+	CHECK(doubleMulti.Count(2.0) == 2);
+	CHECK(doubleMulti.Contains(2));
+}
+
+int main()
+{
+	TestMap();
+	TestConcurrentMap();
+	TestCountMap();
+	TestMultiMap();
+
+	return TEST_RESULT();
+}
\ No newline at end of file
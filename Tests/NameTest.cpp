@@ -0,0 +1,113 @@
+#include "Types/Name.h"
+#include "Types/String.h"
+
+#include "Test.h"
+
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace Quartz;
+
+/*====================================================
+|                QUARTZLIB NAME TESTS                |
+=====================================================*/
+
+static void TestIntern()
+{
+	NamePool pool;
+
+	Name a(WrapperString("texture"), pool);
+	Name b(WrapperString("texture"), pool);
+	Name c(WrapperString("mesh"), pool);
+
+	CHECK(a == b);
+	CHECK(!(a == c));
+	CHECK(a.Id() == b.Id() && a.Id() != c.Id());
+	CHECK(a.GetHash() == b.GetHash());
+	CHECK(a.Length() == 7 && StrCmp(a.Str(), "texture") == 0);
+	CHECK(pool.Size() == 2);
+
+	CHECK(Name::Find("mesh", pool) == c);
+	CHECK(Name::Find("shader", pool).IsEmpty());
+	CHECK(pool.Size() == 2);
+
+	CHECK(Name::FromId(a.Id(), pool) == a);
+	CHECK(Name::FromId(0, pool).IsEmpty());
+
+	Name empty(WrapperString(""), pool);
+	CHECK(empty.IsEmpty() && empty.Id() == 0);
+	CHECK(empty == Name());
+	CHECK(a.IsValid() && empty.IsValid());
+
+	const NameEntry<char>* pEntry = nullptr;
+	CHECK(pool.TryIntern(WrapperString("mesh"), pEntry));
+	CHECK(pEntry == pool.Find(WrapperString("mesh")));
+	CHECK(pool.TryIntern(WrapperString("shader"), pEntry));
+	CHECK(pEntry->id == 3 && pool.Size() == 3);
+	CHECK(pool.FromId(NAME_INVALID_ID) == nullptr);
+}
+
+static void TestGlobal()
+{
+	Name a("global_name");
+	Name b(String("global_name"));
+	CHECK(a == b);
+	CHECK(a.ToString() == String("global_name"));
+
+	NamePool pool;
+	Name c(WrapperString("global_name"), pool);
+	CHECK(!(a == c));
+}
+
+static void TestThreads()
+{
+	NamePool pool;
+	const uSize threadCount = 4;
+	const uSize nameCount = 2000;
+
+	std::vector<std::vector<uInt32>> ids(threadCount, std::vector<uInt32>(nameCount));
+	std::vector<std::thread> threads;
+
+	for (uSize t = 0; t < threadCount; t++)
+	{
+		threads.emplace_back([&, t]()
+		{
+			for (uSize i = 0; i < nameCount; i++)
+			{
+				// Each thread starts at a different name
+				const uSize index = (i + t * nameCount / threadCount) % nameCount;
+				const std::string text = "name" + std::to_string(index);
+
+				ids[t][index] = Name(WrapperString(text.c_str()), pool).Id();
+			}
+		});
+	}
+
+	for (std::thread& thread : threads)
+	{
+		thread.join();
+	}
+
+	CHECK(pool.Size() == nameCount);
+
+	for (uSize i = 0; i < nameCount; i++)
+	{
+		for (uSize t = 1; t < threadCount; t++)
+		{
+			CHECK(ids[t][i] == ids[0][i]);
+		}
+
+		const std::string text = "name" + std::to_string(i);
+		CHECK(StrCmp(Name::FromId(ids[0][i], pool).Str(), text.c_str()) == 0);
+	}
+}
+
+int main()
+{
+	TestIntern();
+	TestGlobal();
+	TestThreads();
+
+	return TEST_RESULT();
+}
\ No newline at end of file
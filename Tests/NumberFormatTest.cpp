@@ -0,0 +1,130 @@
+#include "Utility/NumberFormat.h"
+
+#include "Test.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <string>
+
+using namespace Quartz;
+
+/*====================================================
+|            QUARTZLIB NUMBER FORMAT TESTS           |
+=====================================================*/
+
+static std::string FormatInt64(int64 value)
+{
+	char buffer[NUMBER_MAX_CHARS];
+	return std::string(buffer, FormatInt(value, buffer));
+}
+
+static void TestIntegers()
+{
+	CHECK(FormatInt64(0) == "0");
+	CHECK(FormatInt64(-1) == "-1");
+	CHECK(FormatInt64(std::numeric_limits<int64>::min()) == "-9223372036854775808");
+	CHECK(FormatInt64(std::numeric_limits<int64>::max()) == "9223372036854775807");
+
+	char buffer[NUMBER_MAX_CHARS];
+	CHECK(std::string(buffer, FormatUInt(~uInt64(0), buffer)) == "18446744073709551615");
+
+	for (uSize i = 0; i < 10000; i++)
+	{
+		const int64 value = static_cast<int64>(TestRandom()) >> (TestRandom() % 64);
+		const std::string text = FormatInt64(value);
+		CHECK(text == std::to_string(value));
+
+		int64 parsed = 0;
+		CHECK(ParseInt(text.data(), text.size(), parsed) == text.size());
+		CHECK(parsed == value);
+	}
+
+	uInt64 value = 0;
+	CHECK(ParseUInt("123abc", 6, value) == 3 && value == 123);
+	CHECK(ParseUInt("abc", 3, value) == 0);
+	CHECK(ParseUInt("99999999999999999999", 20, value) == 0);
+
+	wchar_t wide[NUMBER_MAX_CHARS];
+	const uSize count = FormatInt(int64(-42), wide);
+	CHECK(count == 3 && wide[0] == L'-' && wide[1] == L'4' && wide[2] == L'2');
+}
+
+static void TestFloats()
+{
+	const double values[] = { 0.0, 1.0, -1.5, 0.1, 1e-300, 1.7976931348623157e308,
+		5e-324, 123456.789, 3.141592653589793, 1e21, 1e-7 };
+
+	for (double expected : values)
+	{
+		char buffer[NUMBER_MAX_CHARS];
+		const uSize count = FormatFloat(expected, buffer);
+		CHECK(count > 0 && count <= NUMBER_MAX_CHARS);
+
+		double parsed = 0.0;
+		CHECK(ParseFloat(buffer, count, parsed) == count);
+		CHECK(parsed == expected);
+	}
+
+	// Shortest round trip for random bit patterns
+	for (uSize i = 0; i < 20000; i++)
+	{
+		uInt64 bits = TestRandom();
+		double value;
+		memcpy(&value, &bits, sizeof(value));
+
+		if (value != value || value - value != 0.0)
+		{
+			continue;
+		}
+
+		char buffer[NUMBER_MAX_CHARS + 1];
+		const uSize count = FormatFloat(value, buffer);
+		buffer[count] = 0;
+
+		double parsed = 0.0;
+		CHECK(ParseFloat(buffer, count, parsed) == count);
+		CHECK(parsed == value);
+		CHECK(strtod(buffer, nullptr) == value);
+	}
+
+	for (uSize i = 0; i < 20000; i++)
+	{
+		uInt32 bits = static_cast<uInt32>(TestRandom());
+		float value;
+		memcpy(&value, &bits, sizeof(value));
+
+		if (value != value || value - value != 0.0f)
+		{
+			continue;
+		}
+
+		char buffer[NUMBER_MAX_CHARS + 1];
+		const uSize count = FormatFloat(value, buffer);
+		buffer[count] = 0;
+
+		float parsed = 0.0f;
+		CHECK(ParseFloat(buffer, count, parsed) == count);
+		CHECK(parsed == value);
+		CHECK(strtof(buffer, nullptr) == value);
+	}
+
+	// Parsing agrees with strtod on decimal text
+	const char* texts[] = { "0.3", "2.5e-3", "-7.25E+10", "1e400", "4.9e-324",
+		"123456789012345678901234567890", "0.1000000000000000055511151231257827" };
+
+	for (const char* pText : texts)
+	{
+		double parsed = 0.0;
+		CHECK(ParseFloat(pText, strlen(pText), parsed) == strlen(pText));
+		CHECK(parsed == strtod(pText, nullptr));
+	}
+}
+
+int main()
+{
+	TestIntegers();
+	TestFloats();
+
+	return TEST_RESULT();
+}
\ No newline at end of file
@@ -0,0 +1,131 @@
+#include "Utility/StreamReader.h"
+
+#include "Test.h"
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+using namespace Quartz;
+
+/*====================================================
+|            QUARTZLIB STREAM READER TESTS           |
+=====================================================*/
+
+static const char* TEXT = "first line\r\nsecond line\n  42 -7 3.5 2.25\nkey=value;rest";
+
+/* Reads TEXT through every interface, so all readers see the same input */
+static void CheckText(StreamReader& reader)
+{
+	CHECK(reader.Peek() == 'f');
+	CHECK(reader.ReadLine() == WrapperString("first line"));
+	CHECK(reader.ReadLine() == WrapperString("second line"));
+
+	CHECK(reader.ReadInt() == 42);
+	CHECK(reader.ReadInt() == -7);
+	CHECK(reader.ReadFloat() == 3.5f);
+	CHECK(reader.ReadDouble() == 2.25);
+
+	reader.SkipWhitespace();
+	CHECK(reader.ReadTo("=") == WrapperString("key"));
+	CHECK(reader.Read() == '=');
+	CHECK(reader.ReadThrough(";") == WrapperString("value"));
+	CHECK(reader.GetOffset() == strlen(TEXT) - 4);
+	CHECK(reader.ReadLine() == WrapperString("rest"));
+	CHECK(reader.IsEnd());
+	CHECK(reader.Read() == 0);
+
+	int64 value = 0;
+	CHECK(!reader.ReadInt(value));
+}
+
+struct TextSource
+{
+	const char*	pText;
+	uSize		offset;
+	uSize		step;
+};
+
+/* Refills at most step characters at a time, to split reads across refills */
+static uSize RefillText(void* pUser, char* pBuffer, uSize capacity)
+{
+	TextSource& source = *static_cast<TextSource*>(pUser);
+	const uSize remaining = strlen(source.pText) - source.offset;
+	uSize count = remaining < capacity ? remaining : capacity;
+	count = count < source.step ? count : source.step;
+
+	memcpy(pBuffer, source.pText + source.offset, count);
+	source.offset += count;
+
+	return count;
+}
+
+static void TestMemory()
+{
+	StreamReader reader(TEXT, strlen(TEXT));
+	CheckText(reader);
+}
+
+static void TestStream()
+{
+	for (uSize step = 1; step < 8; step++)
+	{
+		TextSource source = { TEXT, 0, step };
+		StreamReader reader(RefillText, &source, 4);
+		CheckText(reader);
+	}
+
+	// A piece longer than the buffer grows it
+	std::string longLine(1000, 'x');
+	longLine += "\nend";
+
+	TextSource source = { longLine.c_str(), 0, 16 };
+	StreamReader reader(RefillText, &source, 64);
+	CHECK(reader.ReadLine().Length() == 1000);
+	CHECK(reader.ReadLine() == WrapperString("end"));
+	CHECK(reader.IsEnd());
+}
+
+static void TestFile()
+{
+	const char* pPath = "StreamReaderTest.txt";
+	FILE* pFile = fopen(pPath, "wb");
+	CHECK(pFile != nullptr);
+
+	if (!pFile)
+	{
+		return;
+	}
+
+	fwrite(TEXT, 1, strlen(TEXT), pFile);
+	fclose(pFile);
+
+	StreamReader reader;
+	CHECK(reader.Open(pPath));
+	CheckText(reader);
+
+	StreamReader missing;
+	CHECK(!missing.Open("StreamReaderTest.missing"));
+
+	reader = StreamReader();
+	remove(pPath);
+}
+
+static void TestWide()
+{
+	const wchar_t* pText = L"one\ntwo";
+	StreamReaderW reader(pText, 7);
+	CHECK(reader.ReadLine() == WrapperStringW(L"one"));
+	CHECK(reader.ReadLine() == WrapperStringW(L"two"));
+	CHECK(reader.IsEnd());
+}
+
+int main()
+{
+	TestMemory();
+	TestStream();
+	TestFile();
+	TestWide();
+
+	return TEST_RESULT();
+}
\ No newline at end of file
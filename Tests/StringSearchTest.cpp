@@ -0,0 +1,100 @@
+#include "Utility/StringSearch.h"
+#include "Types/String.h"
+
+#include "Test.h"
+
+#include <cstring>
+#include <string>
+
+using namespace Quartz;
+
+/*====================================================
+|            QUARTZLIB STRING SEARCH TESTS           |
+=====================================================*/
+
+/* Converts a std::string position to the pointer the search functions return */
+static const char* PosToPtr(const std::string& str, size_t pos)
+{
+	return pos == std::string::npos ? nullptr : str.data() + pos;
+}
+
+static std::string RandomText(uSize length, uSize alphabet)
+{
+	std::string text(length, 'a');
+
+	for (uSize i = 0; i < length; i++)
+	{
+		text[i] = static_cast<char>('a' + TestRandom() % alphabet);
+	}
+
+	return text;
+}
+
+static void TestFind()
+{
+	// Lengths around the vector widths, with a small alphabet for partial matches
+	for (uSize length = 0; length < 140; length++)
+	{
+		const std::string text = RandomText(length, 3);
+
+		for (uSize subLength = 1; subLength < 6; subLength++)
+		{
+			const std::string sub = RandomText(subLength, 3);
+
+			CHECK(StrFind(text.data(), length, sub.data(), subLength) == PosToPtr(text, text.find(sub)));
+			CHECK(StrFindReverse(text.data(), length, sub.data(), subLength) == PosToPtr(text, text.rfind(sub)));
+		}
+
+		const char c = static_cast<char>('a' + TestRandom() % 4);
+		CHECK(StrFindChar(text.data(), length, c) == PosToPtr(text, text.find(c)));
+		CHECK(StrFindCharReverse(text.data(), length, c) == PosToPtr(text, text.rfind(c)));
+
+		const char* pSet = "cx";
+		CHECK(StrFindAny(text.data(), length, pSet, 2) == PosToPtr(text, text.find_first_of(pSet)));
+	}
+
+	const std::string longText = RandomText(5000, 2) + "needle" + RandomText(100, 2);
+	CHECK(StrFind(longText.data(), longText.size(), "needle", 6) == longText.data() + 5000);
+	CHECK(StrFindReverse(longText.data(), longText.size(), "needle", 6) == longText.data() + 5000);
+}
+
+static void TestWide()
+{
+	const wchar_t* pText = L"the quick brown fox jumps over the lazy dog";
+	const uSize length = StrLen(pText);
+
+	CHECK(length == wcslen(pText));
+	CHECK(StrFind(pText, length, L"the", 3) == pText);
+	CHECK(StrFindReverse(pText, length, L"the", 3) == pText + 31);
+	CHECK(StrFindChar(pText, length, L'z') == pText + 37);
+	CHECK(StrFind(pText, length, L"cat", 3) == nullptr);
+}
+
+static void TestLenCmp()
+{
+	for (uSize length = 0; length < 200; length++)
+	{
+		const std::string text = RandomText(length, 26);
+		CHECK(StrLen(text.c_str()) == length);
+
+		std::string other = text;
+
+		if (length > 0)
+		{
+			other[TestRandom() % length] = 'A';
+		}
+
+		const int expected = strcmp(text.c_str(), other.c_str());
+		const sSize result = StrCmp(text.c_str(), other.c_str());
+		CHECK((expected < 0) == (result < 0) && (expected > 0) == (result > 0));
+	}
+}
+
+int main()
+{
+	TestFind();
+	TestWide();
+	TestLenCmp();
+
+	return TEST_RESULT();
+}
\ No newline at end of file
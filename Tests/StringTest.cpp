@@ -0,0 +1,172 @@
+#include "Types/String.h"
+#include "Types/Array.h"
+#include "Types/StringBuilder.h"
+#include "Utility/StringReader.h"
+
+#include "Test.h"
+
+using namespace Quartz;
+
+/*====================================================
+|               QUARTZLIB STRING TESTS               |
+=====================================================*/
+
+static void TestSubstringMove()
+{
+	// Substrings of small strings hold their own copy of the characters,
+	// which Array moves with MemMove
+	Array<Substring> substrings;
+	substrings.PushBack(String("abc").Substring(1));
+	substrings.PushBack(String("xyz").Substring(0, 2));
+
+	substrings.Remove(0);
+	CHECK(substrings.Size() == 1);
+	CHECK(substrings[0] == WrapperString("xy"));
+
+	substrings.PushFront(String("abc").Substring(0, 1));
+	CHECK(substrings[0] == WrapperString("a"));
+	CHECK(substrings[1] == WrapperString("xy"));
+
+	const String large("a string too long to be stored inline in the String");
+	substrings.PushFront(large.Substring(2, 8));
+	substrings.PushFront(String("def").Substring(1, 2));
+	substrings.Remove(1);
+	CHECK(substrings[0] == WrapperString("e"));
+	CHECK(substrings[1] == WrapperString("a"));
+	CHECK(substrings[2] == WrapperString("xy"));
+
+	for (uSize i = 0; i < 100; i++)
+	{
+		const Substring last = substrings[substrings.Size() - 1];
+		substrings.PushFront(last);
+	}
+
+	CHECK(substrings[0] == WrapperString("xy"));
+}
+
+static void TestSubstringCopies()
+{
+	Substring small = String("hello").Substring(1, 4);
+	Substring large = String("hello, this string is long enough for the heap").Substring(7, 11);
+
+	Substring copy(small);
+	CHECK(copy == WrapperString("ell"));
+
+	Substring nested = small.Substring(1);
+	CHECK(nested == WrapperString("ll"));
+
+	Substring moved(Move(copy));
+	CHECK(moved == WrapperString("ell"));
+
+	Swap(moved, large);
+	CHECK(moved == WrapperString("this"));
+	CHECK(large == WrapperString("ell"));
+
+	moved = large;
+	CHECK(moved == WrapperString("ell"));
+
+	// A WrapperString copied from a Substring views its characters
+	WrapperString wrapper = small;
+	CHECK(wrapper.Str() == small.Str());
+	CHECK(wrapper == WrapperString("ell"));
+
+	CHECK(String(small) == String("ell"));
+	CHECK(Substring().IsEmpty());
+
+	uSize count = 0;
+
+	for (const Substring& field : String("a,b,c").Split(","))
+	{
+		CHECK(field.Length() == 1);
+		count++;
+	}
+
+	CHECK(count == 3);
+}
+
+static void TestCachedHash()
+{
+	// Heap strings cache their hash, which writes through Data() must reset
+	String str1("a string too long to be stored inline, version one");
+	String str2("a string too long to be stored inline, version two");
+	String copy = str2;
+	str1.GetHash();
+	str2.GetHash();
+	CHECK(str1 != str2);
+
+	const String one("one");
+	MemCopy(str2.Data() + str2.Length() - 3, one.Str(), 3 * sizeof(char));
+	CHECK(str1 == str2);
+	CHECK(copy == str1);
+	CHECK(str2.GetHash() == str1.GetHash());
+
+	char buffer[] = "abc";
+	WrapperString wrapper(buffer, 3);
+	WrapperString expected("xbc");
+	wrapper.GetHash();
+	expected.GetHash();
+	wrapper.Data()[0] = 'x';
+	CHECK(wrapper == expected);
+
+	// Assigning a wrapper replaces its cached hash too
+	WrapperString assigned("123");
+	WrapperString other("456");
+	assigned.GetHash();
+	other.GetHash();
+	assigned = WrapperString("456");
+	CHECK(assigned == other);
+	CHECK(assigned.GetHash() == other.GetHash());
+}
+
+static void TestBuilderSelfAppend()
+{
+	StringBuilder builder;
+	builder.Append("abcd");
+
+	// Each append outgrows the buffer the appended view points into
+	for (uSize i = 0; i < 6; i++)
+	{
+		builder.Append(builder.View());
+	}
+
+	CHECK(builder.Length() == 4 * 64);
+
+	const String result = builder.ToString();
+
+	for (uSize i = 0; i < result.Length(); i++)
+	{
+		CHECK(result.Str()[i] == 'a' + i % 4);
+	}
+
+	StringBuilder partial;
+	partial.Append("0123456789");
+	const WrapperString view = partial.View();
+	partial.Append(WrapperString(view.Str() + 5, 5));
+	CHECK(partial.View() == WrapperString("012345678956789"));
+}
+
+static void TestReaderLines()
+{
+	StringReader reader(String("first\r\nsecond\nthird"));
+	CHECK(reader.ReadLine() == WrapperString("first"));
+	CHECK(reader.ReadLine() == WrapperString("second"));
+	CHECK(reader.ReadLine() == WrapperString("third"));
+	CHECK(reader.IsEmpty());
+
+	StringReaderW wideReader(StringW(L"first\r\nsecond\nthird"));
+	CHECK(wideReader.ReadLine() == WrapperStringW(L"first"));
+	CHECK(wideReader.ReadLine() == WrapperStringW(L"second"));
+	CHECK(wideReader.ReadLine() == WrapperStringW(L"third"));
+	CHECK(wideReader.IsEmpty());
+}
+
+int main()
+{
+	TestSubstringMove();
+	TestSubstringCopies();
+	TestCachedHash();
+	TestBuilderSelfAppend();
+	TestReaderLines();
+
+	return TEST_RESULT();
+}
\ No newline at end of file
@@ -0,0 +1,89 @@
+#include "Types/Table.h"
+#include "Types/Map.h"
+
+#include "Test.h"
+
+using namespace Quartz;
+
+/*====================================================
+|               QUARTZLIB TABLE TESTS                |
+=====================================================*/
+
+struct ShrinkingPolicy : public TablePolicy
+{
+	constexpr static float SHRINK_LOAD_FACTOR = 0.25f;
+};
+
+static void TestRemoveWhileIterating()
+{
+	Map<int, int, uSize, ShrinkingPolicy> map;
+
+	for (int i = 0; i < 1000; i++)
+	{
+		map.Put(i, i * 2);
+	}
+
+	const uSize capacity = map.Capacity();
+	uSize visited = 0;
+
+	for (auto it = map.Begin(); it != map.End();)
+	{
+		visited++;
+		it = it->key % 10 != 0 ? map.Remove(it) : ++it;
+	}
+
+	// Removing by iterator does not shrink, so nothing was skipped
+	CHECK(visited >= 1000);
+	CHECK(map.Size() == 100);
+	CHECK(map.Capacity() == capacity);
+
+	for (int i = 0; i < 1000; i++)
+	{
+		CHECK(map.Contains(i) == (i % 10 == 0));
+	}
+
+	// Removing by key still shrinks under the policy
+	for (int i = 0; i < 1000; i += 10)
+	{
+		map.Remove(i);
+	}
+
+	CHECK(map.Size() == 0);
+	CHECK(map.Capacity() < capacity);
+}
+
+static void TestRemoveWrapped()
+{
+	// Three entries with the home slot 15 of a 16 slot table,
+	// stored in slots 15, 0 and 1
+	Table<int> table(16);
+	CHECK(table.Capacity() == 16);
+
+	table.Insert(15, 1);
+	table.Insert(15, 2);
+	table.Insert(15, 3);
+
+	Table<int>::Iterator it = table.Begin();
+	CHECK(it->keyValue == 2);
+
+	// The entry from slot 1 shifts into slot 0 and is returned
+	it = table.Remove(it);
+	CHECK(it != table.End() && it->keyValue == 3);
+
+	++it;
+	CHECK(it != table.End() && it->keyValue == 1);
+
+	// The entry from slot 0 wraps into slot 15, and was already visited
+	it = table.Remove(it);
+	CHECK(it == table.End());
+	CHECK(table.Size() == 1);
+	CHECK(table.Contains(15, 3));
+}
+
+int main()
+{
+	TestRemoveWhileIterating();
+	TestRemoveWrapped();
+
+	return TEST_RESULT();
+}
\ No newline at end of file
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstdio>
+
+/*====================================================
+|                  QUARTZLIB TESTS                   |
+=====================================================*/
+
+/*
+	A minimal check macro shared by the tests. Failed checks are printed
+	and counted, and TEST_RESULT() is the exit code of the test.
+*/
+
+inline int& _TestFailures()
+{
+	static int failures = 0;
+	return failures;
+}
+
+#define CHECK(condition) \
+	if (!(condition)) { printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition); ++_TestFailures(); }
+
+#define TEST_RESULT() (_TestFailures() == 0 ? 0 : 1)
+
+/* A fixed-seed xorshift generator, so that failures reproduce */
+inline unsigned long long TestRandom()
+{
+	static unsigned long long state = 0x9E3779B97F4A7C15ull;
+	state ^= state << 13;
+	state ^= state >> 7;
+	state ^= state << 17;
+	return state;
+}
\ No newline at end of file